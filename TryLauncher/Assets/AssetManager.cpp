@@ -1,14 +1,16 @@
 #include "AssetManager.h"
 #include "Texture.h"
+#include "TextureUploader.h"
 #include "../UI/UIDocument.h"
 #include "../Vulkan/VulkanRenderer.h"
 #include "../Vulkan/ResourceManager.h"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
 
-AssetManager::AssetManager(VulkanRenderer* renderer, ResourceManager* resourceManager)
-    : m_renderer(renderer), m_resourceManager(resourceManager), m_assetBasePath("assets/") {
+AssetManager::AssetManager(VulkanRenderer* renderer, ResourceManager* resourceManager, JobSystem* jobSystem)
+    : m_renderer(renderer), m_resourceManager(resourceManager), m_jobSystem(jobSystem), m_assetBasePath("assets/") {
 }
 
 AssetManager::~AssetManager() {
@@ -53,6 +55,13 @@ bool AssetManager::Initialize() {
     
     std::cout << "Asset base path: " << std::filesystem::absolute(m_assetBasePath) << std::endl;
     
+    // Batched texture uploads; without it LoadTextureAsync falls back to LoadTexture
+    m_textureUploader = std::make_unique<TextureUploader>(m_renderer, m_resourceManager);
+    if (!m_textureUploader->Initialize()) {
+        std::cerr << "AssetManager: Texture uploader unavailable, async texture loads will block" << std::endl;
+        m_textureUploader.reset();
+    }
+    
     m_initialized = true;
     std::cout << "AssetManager initialized successfully" << std::endl;
     return true;
@@ -63,7 +72,10 @@ void AssetManager::Update(float deltaTime) {
         return;
     }
     
+    UpdateAsyncTextures();
+    
     // Clean up expired weak pointers
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
     for (auto it = m_assetCache.begin(); it != m_assetCache.end();) {
         if (it->second.expired()) {
             it = m_assetCache.erase(it);
@@ -80,6 +92,40 @@ void AssetManager::Shutdown() {
     
     std::cout << "Shutting down AssetManager..." << std::endl;
     
+    // Let in-flight decodes finish before the uploader goes away
+    std::vector<JobHandle> decodeJobs;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        decodeJobs.swap(m_decodeJobs);
+    }
+    if (m_jobSystem) {
+        for (const auto& job : decodeJobs) {
+            m_jobSystem->Wait(job);
+        }
+    }
+    
+    if (m_textureUploader) {
+        m_textureUploader->Shutdown();
+        m_textureUploader.reset();
+    }
+    
+    // Loads that never reached the GPU fail
+    std::vector<DecodedTexture> unstaged;
+    std::unordered_map<std::string, std::shared_ptr<TextureLoadHandle>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        unstaged.swap(m_unstagedTextures);
+        pending.swap(m_pendingTextureLoads);
+    }
+    for (auto& decoded : unstaged) {
+        stbi_image_free(decoded.pixels);
+    }
+    for (auto& entry : pending) {
+        if (!entry.second->IsReady()) {
+            entry.second->Complete(nullptr);
+        }
+    }
+    
     // Unload all assets
     UnloadAllAssets();
     
@@ -87,6 +133,30 @@ void AssetManager::Shutdown() {
     std::cout << "AssetManager shutdown complete" << std::endl;
 }
 
+void AssetManager::DeclareUpdateAccess(ModuleAccess& access) const {
+    access.Writes(GetName());
+    // Texture uploads create images and submit on the graphics queue that
+    // ResourceManager's one-shot transfers also use
+    access.Writes("ResourceManager");
+}
+
+double AssetManager::GetIdleTimeout() const {
+    // Decodes finish on workers and uploads complete on the GPU; keep updating until
+    // every handle has been resolved
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        if (!m_pendingTextureLoads.empty() || !m_unstagedTextures.empty()) {
+            return 0.0;
+        }
+    }
+    
+    if (m_textureUploader && m_textureUploader->HasPendingWork()) {
+        return 0.0;
+    }
+    
+    return IEngineModule::GetIdleTimeout();
+}
+
 std::shared_ptr<UIDocument> AssetManager::LoadRMLDocument(const std::string& path) {
     // TODO: Implement in task 8
     std::cout << "LoadRMLDocument placeholder: " << path << std::endl;
@@ -126,13 +196,16 @@ std::shared_ptr<Texture> AssetManager::LoadTexture(const std::string& path) {
     }
     
     // Check cache first
-    auto it = m_assetCache.find(path);
-    if (it != m_assetCache.end()) {
-        if (auto existing = it->second.lock()) {
-            auto texture = std::dynamic_pointer_cast<Texture>(existing);
-            if (texture) {
-                std::cout << "Texture loaded from cache: " << path << std::endl;
-                return texture;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto it = m_assetCache.find(path);
+        if (it != m_assetCache.end()) {
+            if (auto existing = it->second.lock()) {
+                auto texture = std::dynamic_pointer_cast<Texture>(existing);
+                if (texture) {
+                    std::cout << "Texture loaded from cache: " << path << std::endl;
+                    return texture;
+                }
             }
         }
     }
@@ -175,16 +248,20 @@ std::shared_ptr<Texture> AssetManager::LoadTexture(const std::string& path) {
             m_resourceManager->UnmapBuffer(stagingBuffer);
         }
         
-        // Transition image layout and copy data
-        m_resourceManager->TransitionImageLayout(image.image, VK_FORMAT_R8G8B8A8_UNORM,
-                                             VK_IMAGE_LAYOUT_UNDEFINED,
-                                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        
-        m_resourceManager->CopyBufferToImage(stagingBuffer, image, width, height);
-        
-        m_resourceManager->TransitionImageLayout(image.image, VK_FORMAT_R8G8B8A8_UNORM,
-                                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        // Transition image layout and copy data in a single submission
+        auto batch = m_resourceManager->BeginUploadBatch();
+        if (batch) {
+            batch->TransitionImageLayout(image.image, VK_FORMAT_R8G8B8A8_UNORM,
+                                         VK_IMAGE_LAYOUT_UNDEFINED,
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            batch->CopyBufferToImage(stagingBuffer, image, width, height);
+            batch->TransitionImageLayout(image.image, VK_FORMAT_R8G8B8A8_UNORM,
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            if (batch->Submit()) {
+                batch->Wait();
+            }
+        }
         
         // Cleanup staging buffer
         m_resourceManager->DestroyBuffer(stagingBuffer);
@@ -194,12 +271,136 @@ std::shared_ptr<Texture> AssetManager::LoadTexture(const std::string& path) {
     
     // Create texture asset
     auto texture = std::make_shared<Texture>(path, image, width, height);
-    m_assetCache[path] = texture;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_assetCache[path] = texture;
+    }
     
     std::cout << "Loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
     return texture;
 }
 
+std::shared_ptr<TextureLoadHandle> AssetManager::LoadTextureAsync(const std::string& path) {
+    auto handle = std::make_shared<TextureLoadHandle>(path);
+    
+    if (!m_initialized) {
+        std::cerr << "AssetManager not initialized" << std::endl;
+        handle->Complete(nullptr);
+        return handle;
+    }
+    
+    // Already resident
+    std::shared_ptr<Texture> resident;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto it = m_assetCache.find(path);
+        if (it != m_assetCache.end()) {
+            resident = std::dynamic_pointer_cast<Texture>(it->second.lock());
+        }
+    }
+    if (resident) {
+        handle->Complete(resident);
+        return handle;
+    }
+    
+    if (!m_textureUploader) {
+        handle->Complete(LoadTexture(path));
+        return handle;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        auto pending = m_pendingTextureLoads.find(path);
+        if (pending != m_pendingTextureLoads.end()) {
+            return pending->second;
+        }
+        m_pendingTextureLoads[path] = handle;
+    }
+    
+    std::string fullPath = m_assetBasePath + path;
+    if (m_jobSystem) {
+        JobHandle job = m_jobSystem->Schedule([this, handle, fullPath]() {
+            DecodeTexture(handle, fullPath);
+            // The main loop may be idle; its next Update uploads or resolves the result
+            VulkanRenderer::Wake();
+        });
+        
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        m_decodeJobs.push_back(job);
+    } else {
+        DecodeTexture(handle, fullPath);
+    }
+    
+    return handle;
+}
+
+void AssetManager::DecodeTexture(const std::shared_ptr<TextureLoadHandle>& handle, const std::string& fullPath) {
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load(fullPath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    
+    if (!pixels) {
+        std::cerr << "Failed to load texture: " << fullPath << std::endl;
+        handle->Complete(nullptr);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+    
+    // Queue behind earlier loads still waiting for ring space so they stay in order
+    if (m_unstagedTextures.empty() && m_textureUploader->Stage(handle, pixels, width, height)) {
+        stbi_image_free(pixels);
+        return;
+    }
+    
+    // Staging ring is full; Update retries once earlier uploads have retired
+    DecodedTexture decoded;
+    decoded.handle = handle;
+    decoded.pixels = pixels;
+    decoded.width = static_cast<uint32_t>(width);
+    decoded.height = static_cast<uint32_t>(height);
+    m_unstagedTextures.push_back(decoded);
+}
+
+void AssetManager::UpdateAsyncTextures() {
+    if (!m_textureUploader) {
+        return;
+    }
+    
+    // Retire finished uploads and submit this frame's batch
+    std::vector<std::shared_ptr<Texture>> completed = m_textureUploader->Flush();
+    for (const auto& texture : completed) {
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_assetCache[texture->GetPath()] = texture;
+        }
+        std::cout << "Loaded texture: " << texture->GetPath() << " (" << texture->GetWidth() << "x" << texture->GetHeight() << ")" << std::endl;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+    
+    // Retry decodes that found the ring full, oldest first so loads complete in request order
+    size_t staged = 0;
+    for (; staged < m_unstagedTextures.size(); ++staged) {
+        DecodedTexture& decoded = m_unstagedTextures[staged];
+        if (!m_textureUploader->Stage(decoded.handle, decoded.pixels, decoded.width, decoded.height)) {
+            break;
+        }
+        stbi_image_free(decoded.pixels);
+    }
+    m_unstagedTextures.erase(m_unstagedTextures.begin(), m_unstagedTextures.begin() + staged);
+    
+    for (auto it = m_pendingTextureLoads.begin(); it != m_pendingTextureLoads.end();) {
+        if (it->second->IsReady()) {
+            it = m_pendingTextureLoads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    m_decodeJobs.erase(std::remove_if(m_decodeJobs.begin(), m_decodeJobs.end(),
+        [](const JobHandle& job) { return job.IsComplete(); }), m_decodeJobs.end());
+}
+
 bool AssetManager::LoadFont(const std::string& path, const std::string& name) {
     if (!m_initialized) {
         std::cerr << "AssetManager not initialized" << std::endl;
@@ -227,6 +428,7 @@ bool AssetManager::LoadFont(const std::string& path, const std::string& name) {
 }
 
 void AssetManager::UnloadAsset(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
     auto it = m_assetCache.find(path);
     if (it != m_assetCache.end()) {
         m_assetCache.erase(it);
@@ -235,6 +437,7 @@ void AssetManager::UnloadAsset(const std::string& path) {
 }
 
 void AssetManager::UnloadAllAssets() {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
     size_t count = m_assetCache.size();
     m_assetCache.clear();
     std::cout << "Unloaded " << count << " assets" << std::endl;
@@ -243,6 +446,7 @@ void AssetManager::UnloadAllAssets() {
 size_t AssetManager::GetMemoryUsage() const {
     size_t totalMemory = 0;
     
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
     for (const auto& pair : m_assetCache) {
         if (auto asset = pair.second.lock()) {
             totalMemory += asset->GetMemoryUsage();
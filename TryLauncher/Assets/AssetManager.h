@@ -4,11 +4,16 @@
 #include <RmlUi/Core.h>
 
 #include "../Engine/Engine.h"
+#include "../Core/JobSystem.h"
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 class VulkanRenderer;
+class TextureUploader;
+class TextureLoadHandle;
 
 class Asset {
 public:
@@ -22,7 +27,7 @@ class Texture;
 
 class AssetManager : public IEngineModule {
 public:
-    AssetManager(VulkanRenderer* renderer, ResourceManager* resourceManager);
+    AssetManager(VulkanRenderer* renderer, ResourceManager* resourceManager, JobSystem* jobSystem = nullptr);
     ~AssetManager();
 
     // IEngineModule interface
@@ -31,11 +36,17 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "AssetManager"; }
     int GetInitializationOrder() const override { return 400; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::AnyThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override;
+    double GetIdleTimeout() const override;
 
     // Asset loading methods (to be implemented in later tasks)
     std::shared_ptr<UIDocument> LoadRMLDocument(const std::string& path);
     bool LoadStylesheet(const std::string& path);
     std::shared_ptr<Texture> LoadTexture(const std::string& path);
+    // Decodes on the JobSystem and uploads with the next frame's batch; the handle is
+    // ready once the GPU copy has finished. Requests for a path already loading share a handle.
+    std::shared_ptr<TextureLoadHandle> LoadTextureAsync(const std::string& path);
     bool LoadFont(const std::string& path, const std::string& name);
     
     // Asset management
@@ -48,8 +59,30 @@ public:
     const std::string& GetAssetBasePath() const { return m_assetBasePath; }
 
 private:
+    // Decoded pixels waiting for room in the staging ring
+    struct DecodedTexture {
+        std::shared_ptr<TextureLoadHandle> handle;
+        unsigned char* pixels = nullptr; // Owned, released with stbi_image_free
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    void DecodeTexture(const std::shared_ptr<TextureLoadHandle>& handle, const std::string& fullPath);
+    void UpdateAsyncTextures();
+
     VulkanRenderer* m_renderer;
     ResourceManager* m_resourceManager;
+    JobSystem* m_jobSystem;
+    std::unique_ptr<TextureUploader> m_textureUploader;
+
+    // Async loads in progress, keyed by path; guarded by m_asyncMutex
+    mutable std::mutex m_asyncMutex;
+    std::unordered_map<std::string, std::shared_ptr<TextureLoadHandle>> m_pendingTextureLoads;
+    std::vector<DecodedTexture> m_unstagedTextures;
+    std::vector<JobHandle> m_decodeJobs;
+
+    // Update sweeps the cache on a worker while loads run on the caller's thread
+    mutable std::mutex m_cacheMutex;
     std::unordered_map<std::string, std::weak_ptr<Asset>> m_assetCache;
     std::string m_assetBasePath;
     bool m_initialized = false;
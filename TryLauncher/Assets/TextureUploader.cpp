@@ -0,0 +1,391 @@
+#include "TextureUploader.h"
+#include "Texture.h"
+#include "../Vulkan/VulkanRenderer.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+    VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+// TextureLoadHandle
+void TextureLoadHandle::OnReady(Callback callback) {
+    if (!callback) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (!IsReady()) {
+            m_callbacks.push_back(std::move(callback));
+            return;
+        }
+    }
+
+    callback(m_texture);
+}
+
+void TextureLoadHandle::Complete(std::shared_ptr<Texture> texture) {
+    std::vector<Callback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        m_texture = std::move(texture);
+        m_ready.store(true, std::memory_order_release);
+        callbacks.swap(m_callbacks);
+    }
+
+    for (auto& callback : callbacks) {
+        callback(m_texture);
+    }
+}
+
+// TextureUploader
+TextureUploader::TextureUploader(VulkanRenderer* renderer, ResourceManager* resourceManager)
+    : m_renderer(renderer), m_resourceManager(resourceManager) {
+}
+
+TextureUploader::~TextureUploader() {
+    if (m_initialized) {
+        Shutdown();
+    }
+}
+
+bool TextureUploader::Initialize(VkDeviceSize ringSize) {
+    if (m_initialized) {
+        return true;
+    }
+
+    if (!m_renderer || !m_resourceManager) {
+        std::cerr << "TextureUploader: Renderer and ResourceManager are required" << std::endl;
+        return false;
+    }
+
+    m_ringBuffer = m_resourceManager->CreateStagingBuffer(ringSize);
+    if (m_ringBuffer.IsValid()) {
+        m_ringData = static_cast<unsigned char*>(m_resourceManager->MapBuffer(m_ringBuffer));
+    }
+    if (!m_ringData) {
+        std::cerr << "TextureUploader: Failed to create staging ring" << std::endl;
+        m_initialized = true;
+        Shutdown();
+        return false;
+    }
+
+    m_ringSize = ringSize;
+    m_ringHead = 0;
+    m_ringTail = 0;
+    m_ringUsed = 0;
+    m_nextBatch = 0;
+
+    m_initialized = true;
+    std::cout << "TextureUploader initialized (" << (ringSize / (1024 * 1024)) << " MB staging ring)" << std::endl;
+    return true;
+}
+
+void TextureUploader::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    // Let submitted uploads finish so their handles complete normally
+    std::vector<std::shared_ptr<Texture>> completed;
+    for (size_t i = 0; i < MAX_BATCHES_IN_FLIGHT; ++i) {
+        Batch& batch = m_batches[(m_nextBatch + i) % MAX_BATCHES_IN_FLIGHT];
+        if (batch.commands) {
+            batch.commands->Wait();
+            RetireBatch(batch, completed);
+        }
+    }
+
+    // Anything staged but never submitted fails; Stage() refuses new work from here on
+    std::deque<Upload> staged;
+    {
+        std::lock_guard<std::mutex> lock(m_stagingMutex);
+        staged.swap(m_staged);
+        m_initialized = false;
+    }
+    for (Upload& upload : staged) {
+        FailUpload(upload);
+    }
+
+    if (m_ringBuffer.IsValid()) {
+        // Persistently mapped through VMA; destroying the buffer releases the mapping
+        m_resourceManager->DestroyBuffer(m_ringBuffer);
+        m_ringBuffer = {};
+    }
+    m_ringData = nullptr;
+}
+
+bool TextureUploader::Stage(const std::shared_ptr<TextureLoadHandle>& handle,
+                            const unsigned char* pixels, uint32_t width, uint32_t height) {
+    VkDeviceSize size = static_cast<VkDeviceSize>(width) * height * 4;
+
+    Upload upload;
+    upload.handle = handle;
+    upload.width = width;
+    upload.height = height;
+
+    std::lock_guard<std::mutex> lock(m_stagingMutex);
+    if (!m_initialized) {
+        return false;
+    }
+
+    if (size > m_ringSize) {
+        // Too large for the ring: gets its own staging buffer at submit time
+        upload.oversizePixels.assign(pixels, pixels + size);
+        m_staged.push_back(std::move(upload));
+        return true;
+    }
+
+    if (!AllocateRing(size, upload)) {
+        return false;
+    }
+
+    // Copy under the lock so the staged list stays in ring order
+    std::memcpy(m_ringData + upload.offset, pixels, static_cast<size_t>(size));
+    m_staged.push_back(std::move(upload));
+    return true;
+}
+
+bool TextureUploader::AllocateRing(VkDeviceSize size, Upload& upload) {
+    if (m_ringUsed == 0) {
+        m_ringHead = 0;
+        m_ringTail = 0;
+    } else if (m_ringHead == m_ringTail) {
+        return false; // Full
+    }
+
+    VkDeviceSize start = AlignUp(m_ringHead, RING_ALIGNMENT);
+    VkDeviceSize consumed = 0;
+
+    if (m_ringHead >= m_ringTail) {
+        // Free space is [head, size) followed by [0, tail)
+        if (start + size <= m_ringSize) {
+            consumed = start + size - m_ringHead;
+        } else if (size <= m_ringTail) {
+            consumed = (m_ringSize - m_ringHead) + size;
+            start = 0;
+        } else {
+            return false;
+        }
+    } else {
+        // Free space is [head, tail)
+        if (start + size > m_ringTail) {
+            return false;
+        }
+        consumed = start + size - m_ringHead;
+    }
+
+    m_ringHead = start + size;
+    m_ringUsed += consumed;
+
+    upload.offset = start;
+    upload.ringEnd = m_ringHead;
+    upload.ringConsumed = consumed;
+    return true;
+}
+
+std::vector<std::shared_ptr<Texture>> TextureUploader::Flush() {
+    std::vector<std::shared_ptr<Texture>> completed;
+    if (!m_initialized) {
+        return completed;
+    }
+
+    // Retire in submission order so ring space is reclaimed in allocation order
+    for (size_t i = 0; i < MAX_BATCHES_IN_FLIGHT; ++i) {
+        Batch& batch = m_batches[(m_nextBatch + i) % MAX_BATCHES_IN_FLIGHT];
+        if (!batch.commands) {
+            continue;
+        }
+        if (!batch.commands->IsComplete()) {
+            break;
+        }
+        RetireBatch(batch, completed);
+    }
+
+    std::vector<Upload> uploads;
+    {
+        std::lock_guard<std::mutex> lock(m_stagingMutex);
+        if (m_staged.empty()) {
+            return completed;
+        }
+
+        // Every batch still on the GPU: keep staging and try next frame
+        if (m_batches[m_nextBatch].commands) {
+            return completed;
+        }
+
+        uploads.reserve(m_staged.size());
+        for (Upload& upload : m_staged) {
+            uploads.push_back(std::move(upload));
+        }
+        m_staged.clear();
+    }
+
+    Batch& batch = m_batches[m_nextBatch];
+    if (SubmitBatch(batch, uploads, completed)) {
+        m_nextBatch = (m_nextBatch + 1) % MAX_BATCHES_IN_FLIGHT;
+    }
+
+    return completed;
+}
+
+bool TextureUploader::SubmitBatch(Batch& batch, std::vector<Upload>& uploads,
+                                  std::vector<std::shared_ptr<Texture>>& completed) {
+    batch.uploads.clear();
+    batch.ringEnd = 0;
+    batch.ringConsumed = 0;
+    batch.usesRing = false;
+
+    for (Upload& upload : uploads) {
+        if (upload.ringConsumed > 0) {
+            batch.ringEnd = upload.ringEnd;
+            batch.ringConsumed += upload.ringConsumed;
+            batch.usesRing = true;
+        }
+
+        upload.image = m_resourceManager->CreateTexture2D(upload.width, upload.height, VK_FORMAT_R8G8B8A8_UNORM);
+        if (!upload.image.IsValid()) {
+            std::cerr << "Failed to create Vulkan texture for: " << upload.handle->GetPath() << std::endl;
+            FailUpload(upload);
+            continue;
+        }
+
+        if (!upload.oversizePixels.empty()) {
+            VkDeviceSize size = upload.oversizePixels.size();
+            upload.dedicatedBuffer = m_resourceManager->CreateStagingBuffer(size);
+            void* data = upload.dedicatedBuffer.IsValid() ? m_resourceManager->MapBuffer(upload.dedicatedBuffer) : nullptr;
+            if (!data) {
+                std::cerr << "Failed to stage texture: " << upload.handle->GetPath() << std::endl;
+                FailUpload(upload);
+                continue;
+            }
+            std::memcpy(data, upload.oversizePixels.data(), upload.oversizePixels.size());
+            upload.oversizePixels.clear();
+            upload.oversizePixels.shrink_to_fit();
+        }
+
+        batch.uploads.push_back(std::move(upload));
+    }
+
+    // Async uploads go to the transfer queue where possible, keeping them off the path of frame submissions
+    batch.commands = m_resourceManager->BeginUploadBatch(UploadQueue::Transfer);
+    if (!batch.commands) {
+        AbortBatch(batch, completed);
+        return false;
+    }
+
+    // Even when every upload failed the batch is still submitted (without commands):
+    // its timeline value orders the release of its ring space behind older batches
+    RecordBatch(batch);
+
+    if (!batch.commands->Submit()) {
+        std::cerr << "TextureUploader: Failed to submit uploads" << std::endl;
+        AbortBatch(batch, completed);
+        return false;
+    }
+
+    return true;
+}
+
+void TextureUploader::RecordBatch(Batch& batch) {
+    UploadBatch& commands = *batch.commands;
+
+    // All transitions, then all copies, then all transitions back. Each group is emitted
+    // as a single merged barrier, so the transfers overlap instead of waiting on each other.
+    for (const Upload& upload : batch.uploads) {
+        commands.TransitionImageLayout(upload.image.image, VK_FORMAT_R8G8B8A8_UNORM,
+                                       VK_IMAGE_LAYOUT_UNDEFINED,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    }
+
+    for (const Upload& upload : batch.uploads) {
+        if (upload.dedicatedBuffer.IsValid()) {
+            commands.CopyBufferToImage(upload.dedicatedBuffer, upload.image, upload.width, upload.height);
+        } else {
+            commands.CopyBufferToImage(m_ringBuffer, upload.image, upload.width, upload.height, 1, upload.offset);
+        }
+    }
+
+    for (const Upload& upload : batch.uploads) {
+        commands.TransitionImageLayout(upload.image.image, VK_FORMAT_R8G8B8A8_UNORM,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+}
+
+void TextureUploader::AbortBatch(Batch& batch, std::vector<std::shared_ptr<Texture>>& completed) {
+    batch.commands.reset();
+
+    // Older batches own ring space in front of ours; retire them first
+    for (Batch& other : m_batches) {
+        if (other.commands) {
+            other.commands->Wait();
+            RetireBatch(other, completed);
+        }
+    }
+
+    for (Upload& upload : batch.uploads) {
+        FailUpload(upload);
+    }
+    batch.uploads.clear();
+
+    std::lock_guard<std::mutex> lock(m_stagingMutex);
+    if (batch.usesRing) {
+        m_ringTail = batch.ringEnd;
+        m_ringUsed -= batch.ringConsumed;
+    }
+}
+
+void TextureUploader::RetireBatch(Batch& batch, std::vector<std::shared_ptr<Texture>>& completed) {
+    for (Upload& upload : batch.uploads) {
+        if (upload.dedicatedBuffer.IsValid()) {
+            // Staging buffers are persistently mapped; destroying releases the mapping
+            m_resourceManager->DestroyBuffer(upload.dedicatedBuffer);
+            upload.dedicatedBuffer = {};
+        }
+
+        auto texture = std::make_shared<Texture>(upload.handle->GetPath(), upload.image, upload.width, upload.height);
+        completed.push_back(texture);
+        upload.handle->Complete(std::move(texture));
+    }
+    batch.uploads.clear();
+    batch.commands.reset();
+
+    {
+        std::lock_guard<std::mutex> lock(m_stagingMutex);
+        if (batch.usesRing) {
+            m_ringTail = batch.ringEnd;
+            m_ringUsed -= batch.ringConsumed;
+        }
+    }
+}
+
+void TextureUploader::FailUpload(Upload& upload) {
+    if (upload.dedicatedBuffer.IsValid()) {
+        m_resourceManager->DestroyBuffer(upload.dedicatedBuffer);
+        upload.dedicatedBuffer = {};
+    }
+    if (upload.image.IsValid()) {
+        m_resourceManager->DestroyImage(upload.image);
+        upload.image = {};
+    }
+    if (upload.handle) {
+        upload.handle->Complete(nullptr);
+    }
+}
+
+bool TextureUploader::HasPendingWork() const {
+    std::lock_guard<std::mutex> lock(m_stagingMutex);
+    if (!m_staged.empty()) {
+        return true;
+    }
+    for (const Batch& batch : m_batches) {
+        if (batch.commands) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../Vulkan/ResourceManager.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class VulkanRenderer;
+class Texture;
+
+// Progress of one LoadTextureAsync request. Shared between the caller and the loader;
+// duplicate requests for the same path receive the same handle.
+class TextureLoadHandle {
+public:
+    using Callback = std::function<void(const std::shared_ptr<Texture>&)>;
+
+    explicit TextureLoadHandle(const std::string& path) : m_path(path) {}
+
+    const std::string& GetPath() const { return m_path; }
+
+    // True once the upload has finished on the GPU or the load has failed
+    bool IsReady() const { return m_ready.load(std::memory_order_acquire); }
+    bool Succeeded() const { return IsReady() && m_texture != nullptr; }
+    // Null until ready, and after a failed load
+    std::shared_ptr<Texture> GetTexture() const { return IsReady() ? m_texture : nullptr; }
+
+    // Called once the texture is ready, or immediately if it already is. Runs on whichever
+    // thread completes the load: a JobSystem worker running AssetManager::Update or a failed
+    // decode, or the caller. Callbacks must not touch main-thread state such as RmlUi or the
+    // renderer; publish an event through the EventSystem or poll IsReady() there instead.
+    void OnReady(Callback callback);
+
+private:
+    friend class TextureUploader;
+    friend class AssetManager;
+    void Complete(std::shared_ptr<Texture> texture);
+
+    std::string m_path;
+    std::shared_ptr<Texture> m_texture;
+    std::atomic<bool> m_ready{false};
+
+    std::mutex m_callbackMutex;
+    std::vector<Callback> m_callbacks;
+};
+
+/**
+ * TextureUploader batches texture uploads for the AssetManager.
+ * This class handles:
+ * - Staging decoded pixels into a persistently mapped ring buffer from any thread
+ * - Recording every pending layout transition and copy into one UploadBatch per frame
+ * - Tracking submissions with the batch timeline values instead of waiting for the queue to go idle
+ *
+ * Stage() may be called from worker threads; Flush() and Shutdown() must be called
+ * from one thread at a time, as AssetManager::Update does.
+ */
+class TextureUploader {
+public:
+    TextureUploader(VulkanRenderer* renderer, ResourceManager* resourceManager);
+    ~TextureUploader();
+
+    bool Initialize(VkDeviceSize ringSize = DEFAULT_RING_SIZE);
+    void Shutdown();
+
+    // Copies RGBA8 pixels into staging memory. Returns false when the ring is full;
+    // the caller keeps the pixels and retries after the next Flush.
+    bool Stage(const std::shared_ptr<TextureLoadHandle>& handle,
+               const unsigned char* pixels, uint32_t width, uint32_t height);
+
+    // Retires finished submissions, completing their handles, then submits everything
+    // staged since the last call as one batch. Returns the textures completed this call.
+    std::vector<std::shared_ptr<Texture>> Flush();
+
+    bool HasPendingWork() const;
+    VkDeviceSize GetRingSize() const { return m_ringSize; }
+
+    static constexpr VkDeviceSize DEFAULT_RING_SIZE = 32 * 1024 * 1024;
+
+private:
+    struct Upload {
+        std::shared_ptr<TextureLoadHandle> handle;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        VkDeviceSize offset = 0;        // Into the ring, or 0 for a dedicated buffer
+        VkDeviceSize ringEnd = 0;       // Ring head after this allocation
+        VkDeviceSize ringConsumed = 0;  // Bytes taken from the ring, including wrap padding
+        std::vector<unsigned char> oversizePixels; // Images larger than the ring, until submit
+        AllocatedBuffer dedicatedBuffer;           // Their staging buffer once submitted
+        AllocatedImage image;
+    };
+
+    struct Batch {
+        std::unique_ptr<UploadBatch> commands; // Set while in flight
+        std::vector<Upload> uploads;
+        VkDeviceSize ringEnd = 0;
+        VkDeviceSize ringConsumed = 0;
+        bool usesRing = false;
+    };
+
+    static constexpr size_t MAX_BATCHES_IN_FLIGHT = 2;
+    static constexpr VkDeviceSize RING_ALIGNMENT = 16;
+
+    bool AllocateRing(VkDeviceSize size, Upload& upload);
+    void RetireBatch(Batch& batch, std::vector<std::shared_ptr<Texture>>& completed);
+    bool SubmitBatch(Batch& batch, std::vector<Upload>& uploads,
+                     std::vector<std::shared_ptr<Texture>>& completed);
+    void RecordBatch(Batch& batch);
+    void AbortBatch(Batch& batch, std::vector<std::shared_ptr<Texture>>& completed);
+    void FailUpload(Upload& upload);
+
+    VulkanRenderer* m_renderer;
+    ResourceManager* m_resourceManager;
+
+    // Staging ring, persistently mapped. Space is reclaimed in allocation order as
+    // batches complete.
+    AllocatedBuffer m_ringBuffer;
+    unsigned char* m_ringData = nullptr;
+    VkDeviceSize m_ringSize = 0;
+    VkDeviceSize m_ringHead = 0;
+    VkDeviceSize m_ringTail = 0;
+    VkDeviceSize m_ringUsed = 0;
+
+    // Staged uploads in allocation order; guarded by m_stagingMutex with the ring state
+    mutable std::mutex m_stagingMutex;
+    std::deque<Upload> m_staged;
+
+    std::array<Batch, MAX_BATCHES_IN_FLIGHT> m_batches;
+    size_t m_nextBatch = 0;       // Next batch to submit; the oldest one still in flight
+    bool m_initialized = false;
+};
@@ -40,6 +40,11 @@ void AudioManager::Update(float deltaTime) {
     // For now, this is a placeholder
 }
 
+void AudioManager::DeclareUpdateAccess(ModuleAccess& access) const {
+    access.Writes(GetName());
+    access.Reads("SettingsManager");
+}
+
 void AudioManager::Shutdown() {
     if (!m_initialized) {
         return;
@@ -17,6 +17,8 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "AudioManager"; }
     int GetInitializationOrder() const override { return 350; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::AnyThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override;
 
     // Audio settings application
     void ApplyAudioSettings(const EngineConfig::Audio& audio);
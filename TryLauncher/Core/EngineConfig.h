@@ -11,6 +11,9 @@ struct EngineConfig {
         uint32_t windowHeight = 1080;
         bool fullscreen = false;
         bool vsync = true;
+        std::string presentMode = "auto";   // auto (follows vsync), fifo, fifo_relaxed, mailbox, immediate
+        uint32_t framesInFlight = 2;        // Frames the CPU may record ahead of the GPU
+        bool lowLatency = false;            // Wait for the previous present before polling input
         uint32_t msaaSamples = 1;
         bool enableValidation = false;
         std::string preferredGPU = "auto";
@@ -21,12 +24,21 @@ struct EngineConfig {
         static constexpr uint32_t MIN_HEIGHT = 600;
         static constexpr uint32_t MAX_HEIGHT = 4320;
         static constexpr uint32_t MAX_MSAA_SAMPLES = 16;
+        static constexpr uint32_t MIN_FRAMES_IN_FLIGHT = 1;
+        static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+        
+        static bool IsValidPresentMode(const std::string& mode) {
+            return mode == "auto" || mode == "fifo" || mode == "fifo_relaxed" ||
+                   mode == "mailbox" || mode == "immediate";
+        }
         
         bool IsValid() const {
             return windowWidth >= MIN_WIDTH && windowWidth <= MAX_WIDTH &&
                    windowHeight >= MIN_HEIGHT && windowHeight <= MAX_HEIGHT &&
                    (msaaSamples == 1 || msaaSamples == 2 || msaaSamples == 4 || 
-                    msaaSamples == 8 || msaaSamples == 16);
+                    msaaSamples == 8 || msaaSamples == 16) &&
+                   framesInFlight >= MIN_FRAMES_IN_FLIGHT && framesInFlight <= MAX_FRAMES_IN_FLIGHT &&
+                   IsValidPresentMode(presentMode);
         }
     } graphics;
     
@@ -60,10 +72,34 @@ struct EngineConfig {
         }
     } input;
     
+    struct Performance {
+        uint32_t targetFrameRate = 60;      // 0 = uncapped
+        uint32_t fixedUpdateRate = 60;      // Simulation updates per second
+        uint32_t maxFixedStepsPerFrame = 5;
+        uint32_t workerThreadCount = 0;     // 0 = hardware threads - 1
+        bool idleWhenStatic = true;         // Block on input instead of updating while nothing changes
+        
+        // Validation ranges
+        static constexpr uint32_t MIN_TARGET_FRAME_RATE = 15;
+        static constexpr uint32_t MAX_TARGET_FRAME_RATE = 1000;
+        static constexpr uint32_t MIN_FIXED_UPDATE_RATE = 10;
+        static constexpr uint32_t MAX_FIXED_UPDATE_RATE = 1000;
+        static constexpr uint32_t MAX_FIXED_STEPS_PER_FRAME = 32;
+        static constexpr uint32_t MAX_WORKER_THREADS = 64;
+        
+        bool IsValid() const {
+            return (targetFrameRate == 0 ||
+                    (targetFrameRate >= MIN_TARGET_FRAME_RATE && targetFrameRate <= MAX_TARGET_FRAME_RATE)) &&
+                   fixedUpdateRate >= MIN_FIXED_UPDATE_RATE && fixedUpdateRate <= MAX_FIXED_UPDATE_RATE &&
+                   maxFixedStepsPerFrame >= 1 && maxFixedStepsPerFrame <= MAX_FIXED_STEPS_PER_FRAME &&
+                   workerThreadCount <= MAX_WORKER_THREADS;
+        }
+    } performance;
+    
     std::string assetPath = "assets/";
     std::string configPath = "config.json";
     
     bool IsValid() const {
-        return graphics.IsValid() && audio.IsValid() && input.IsValid();
+        return graphics.IsValid() && audio.IsValid() && input.IsValid() && performance.IsValid();
     }
 };
\ No newline at end of file
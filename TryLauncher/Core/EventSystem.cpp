@@ -1,12 +1,155 @@
 #include "EventSystem.h"
+#include <algorithm>
 #include <iostream>
+#include <unordered_map>
 
-EventSystem::EventSystem() = default;
+namespace {
+    std::atomic<uint64_t> s_nextInstanceId{1};
+
+    // Which EventSystem instance the calling thread's cache belongs to
+    thread_local uint64_t t_cacheOwner = 0;
+    thread_local void* t_cache = nullptr;
+
+    struct TypeRegistryState {
+        std::mutex mutex;
+        std::unordered_map<std::type_index, EventTypeId> ids;
+    };
+
+    TypeRegistryState& GetTypeRegistryState() {
+        static TypeRegistryState state;
+        return state;
+    }
+}
+
+// EventTypeRegistry
+EventTypeId EventTypeRegistry::Register(const std::type_index& type) {
+    TypeRegistryState& state = GetTypeRegistryState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    auto it = state.ids.find(type);
+    if (it != state.ids.end()) {
+        return it->second;
+    }
+
+    EventTypeId id = static_cast<EventTypeId>(state.ids.size());
+    state.ids.emplace(type, id);
+    return id;
+}
+
+bool EventTypeRegistry::Find(const std::type_index& type, EventTypeId& outId) {
+    TypeRegistryState& state = GetTypeRegistryState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    auto it = state.ids.find(type);
+    if (it == state.ids.end()) {
+        return false;
+    }
+
+    outId = it->second;
+    return true;
+}
+
+// EventQueue
+EventQueue::EventQueue()
+    : m_head(&m_stub), m_tail(&m_stub) {
+}
+
+void EventQueue::Push(EventNode* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    EventNode* previous = m_head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+EventNode* EventQueue::Pop() {
+    EventNode* tail = m_tail;
+    EventNode* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &m_stub) {
+        if (!next) {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+
+    // A producer has swapped the head but not linked it yet; pick it up next time
+    if (tail != m_head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // Tail is the last node: re-insert the stub so it can be detached
+    Push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+// EventSubscription
+EventSubscription::~EventSubscription() {
+    Reset();
+}
+
+EventSubscription::EventSubscription(EventSubscription&& other) noexcept
+    : m_owner(std::move(other.m_owner)), m_typeId(other.m_typeId), m_id(other.m_id) {
+    other.m_id = 0;
+}
+
+EventSubscription& EventSubscription::operator=(EventSubscription&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        m_owner = std::move(other.m_owner);
+        m_typeId = other.m_typeId;
+        m_id = other.m_id;
+        other.m_id = 0;
+    }
+    return *this;
+}
+
+void EventSubscription::Reset() {
+    if (m_id == 0) {
+        return;
+    }
+
+    if (auto owner = m_owner.lock()) {
+        (*owner)->Unsubscribe(m_typeId, m_id);
+    }
+
+    m_owner.reset();
+    m_id = 0;
+}
+
+// EventSystem
+EventSystem::EventSystem()
+    : m_self(std::make_shared<EventSystem*>(this))
+    , m_dispatchThread(std::this_thread::get_id())
+    , m_instanceId(s_nextInstanceId.fetch_add(1)) {
+    for (auto& slot : m_typeStates) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
 
 EventSystem::~EventSystem() {
     if (m_initialized) {
         Shutdown();
     }
+
+    DiscardQueuedEvents();
+
+    // Threads that published into this instance must not reuse their cache pointers
+    if (t_cacheOwner == m_instanceId) {
+        t_cacheOwner = 0;
+        t_cache = nullptr;
+    }
 }
 
 bool EventSystem::Initialize() {
@@ -15,15 +158,17 @@ bool EventSystem::Initialize() {
     }
 
     std::cout << "Initializing EventSystem..." << std::endl;
-    
+
+    // Handlers run on whichever thread drives the engine
+    m_dispatchThread = std::this_thread::get_id();
+
     // Clear any existing handlers and events
     m_handlers.clear();
-    
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    while (!m_eventQueue.empty()) {
-        m_eventQueue.pop();
-    }
-    
+    m_pendingHandlers.clear();
+    m_dirtyBuckets.clear();
+    m_liveHandlerCount = 0;
+    DiscardQueuedEvents();
+
     m_initialized = true;
     std::cout << "EventSystem initialized" << std::endl;
     return true;
@@ -33,7 +178,7 @@ void EventSystem::Update(float deltaTime) {
     if (!m_initialized) {
         return;
     }
-    
+
     ProcessEvents();
 }
 
@@ -41,52 +186,399 @@ void EventSystem::Shutdown() {
     if (!m_initialized) {
         return;
     }
-    
+
     std::cout << "Shutting down EventSystem..." << std::endl;
-    
-    // Clear all handlers
+
+    // Clear all handlers; outstanding subscriptions become no-ops
     m_handlers.clear();
-    
+    m_pendingHandlers.clear();
+    m_dirtyBuckets.clear();
+    m_liveHandlerCount = 0;
+
     // Clear event queue
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    while (!m_eventQueue.empty()) {
-        m_eventQueue.pop();
-    }
-    
+    DiscardQueuedEvents();
+
     m_initialized = false;
     std::cout << "EventSystem shutdown complete" << std::endl;
 }
 
-void EventSystem::PublishEvent(std::unique_ptr<Event> event) {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    m_eventQueue.push(std::move(event));
+void EventSystem::PublishEvent(std::unique_ptr<Event> event, EventTiming timing) {
+    if (!event) {
+        return;
+    }
+
+    // The static type is unknown here, so this path pays for a registry lookup
+    EventTypeId typeId = EventTypeRegistry::Register(std::type_index(typeid(*event)));
+
+    if (timing == EventTiming::Immediate && IsDispatchThread()) {
+        DispatchToHandlers(typeId, *event);
+        // Handlers may have changed what is on screen; keep the next update busy
+        m_eventsQueued.store(true, std::memory_order_release);
+        return;
+    }
+
+    EventTypeState* state = GetTypeState(typeId);
+    if (state && AbsorbEvent(*state, *event)) {
+        return;
+    }
+
+    EventNode* node = AcquireNode();
+    node->event = event.release();
+    node->inlineStorage = false;
+    Enqueue(node, typeId, state, timing);
 }
 
 void EventSystem::ProcessEvents() {
-    std::queue<std::unique_ptr<Event>> eventsToProcess;
-    
-    // Move events from the queue to local processing queue
+    // Cleared before draining so an event published concurrently is seen next update
+    m_dispatchedLastUpdate = m_eventsQueued.exchange(false, std::memory_order_acq_rel);
+
     {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
-        eventsToProcess.swap(m_eventQueue);
-    }
-    
-    // Process events without holding the mutex
-    while (!eventsToProcess.empty()) {
-        auto& event = eventsToProcess.front();
-        std::string eventType = event->GetType();
-        
-        // Dispatch to all matching handlers
-        for (const auto& handler : m_handlers) {
-            if (handler.eventType == eventType) {
-                try {
-                    handler.handler(*event);
-                } catch (const std::exception& e) {
-                    std::cerr << "Error processing event " << eventType << ": " << e.what() << std::endl;
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        m_producerSnapshot.clear();
+        for (const auto& cache : m_threadCaches) {
+            m_producerSnapshot.push_back(cache.get());
+        }
+    }
+
+    // Take only what is staged now; events published by handlers wait for the next frame.
+    // High-lane events go first so a flood of normal events cannot delay them, and
+    // within a lane events held back last frame precede the ones staged since.
+    m_dispatchBatch.clear();
+    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+        std::vector<EventNode*>& deferred = m_deferredNodes[lane];
+        m_dispatchBatch.insert(m_dispatchBatch.end(), deferred.begin(), deferred.end());
+        deferred.clear();
+
+        for (ThreadCache* producer : m_producerSnapshot) {
+            while (EventNode* node = producer->staging[lane].Pop()) {
+                if (node->deferFrames > 0) {
+                    --node->deferFrames;
+                    deferred.push_back(node);
+                } else {
+                    m_dispatchBatch.push_back(node);
                 }
             }
         }
-        
-        eventsToProcess.pop();
     }
+
+    for (EventNode* node : m_dispatchBatch) {
+        BeginDispatch(node);
+        DispatchToHandlers(node->typeId, *node->event);
+        RetireNode(node);
+    }
+
+    m_dispatchBatch.clear();
+}
+
+double EventSystem::GetIdleTimeout() const {
+    if (m_eventsQueued.load(std::memory_order_acquire) || m_dispatchedLastUpdate) {
+        return 0.0;
+    }
+
+    for (const auto& deferred : m_deferredNodes) {
+        if (!deferred.empty()) {
+            return 0.0;
+        }
+    }
+
+    return IEngineModule::GetIdleTimeout();
+}
+
+void EventSystem::DispatchToHandlers(EventTypeId typeId, const Event& event) {
+    if (typeId >= m_handlers.size()) {
+        return;
+    }
+
+    // Immediate events may arrive while a batch is being dispatched
+    bool outermost = !m_dispatching;
+    m_dispatching = true;
+
+    // Index-based: handlers unsubscribed mid-dispatch leave a tombstone in place, and
+    // handlers subscribed mid-dispatch are staged, so the bucket never reallocates here
+    auto& bucket = m_handlers[typeId];
+    for (size_t i = 0; i < bucket.size(); ++i) {
+        if (bucket[i].id == 0) {
+            continue;
+        }
+        try {
+            bucket[i].handler(event);
+        } catch (const std::exception& e) {
+            std::cerr << "Error processing event " << event.GetType() << ": " << e.what() << std::endl;
+        }
+    }
+
+    if (outermost) {
+        m_dispatching = false;
+        CompactHandlers();
+    }
+}
+
+EventSubscription EventSystem::AddHandler(EventTypeId typeId, EventHandler handler) {
+    HandlerEntry entry;
+    entry.id = m_nextHandlerId++;
+    entry.handler = std::move(handler);
+    uint64_t id = entry.id;
+
+    if (m_dispatching) {
+        // Appending could reallocate the bucket being iterated
+        m_pendingHandlers.emplace_back(typeId, std::move(entry));
+    } else {
+        if (typeId >= m_handlers.size()) {
+            m_handlers.resize(typeId + 1);
+        }
+        m_handlers[typeId].push_back(std::move(entry));
+    }
+
+    ++m_liveHandlerCount;
+    return EventSubscription(m_self, typeId, id);
+}
+
+void EventSystem::Unsubscribe(EventTypeId typeId, uint64_t id) {
+    for (auto& pending : m_pendingHandlers) {
+        if (pending.first == typeId && pending.second.id == id) {
+            pending.second.id = 0;
+            --m_liveHandlerCount;
+            return;
+        }
+    }
+
+    if (typeId >= m_handlers.size()) {
+        return;
+    }
+
+    for (auto& entry : m_handlers[typeId]) {
+        if (entry.id == id) {
+            // Keep the handler object alive until compaction; it may be the one running
+            entry.id = 0;
+            --m_liveHandlerCount;
+            m_dirtyBuckets.push_back(typeId);
+            break;
+        }
+    }
+
+    if (!m_dispatching) {
+        CompactHandlers();
+    }
+}
+
+void EventSystem::CompactHandlers() {
+    for (EventTypeId typeId : m_dirtyBuckets) {
+        auto& bucket = m_handlers[typeId];
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+            [](const HandlerEntry& entry) { return entry.id == 0; }), bucket.end());
+
+        // Release memory left behind by scenes that subscribed many handlers and left
+        if (bucket.capacity() > 16 && bucket.size() < bucket.capacity() / 4) {
+            bucket.shrink_to_fit();
+        }
+    }
+    m_dirtyBuckets.clear();
+
+    for (auto& pending : m_pendingHandlers) {
+        if (pending.second.id == 0) {
+            continue;
+        }
+        if (pending.first >= m_handlers.size()) {
+            m_handlers.resize(pending.first + 1);
+        }
+        m_handlers[pending.first].push_back(std::move(pending.second));
+    }
+    m_pendingHandlers.clear();
+}
+
+EventSystem::ThreadCache& EventSystem::GetThreadCache() {
+    if (t_cacheOwner != m_instanceId) {
+        auto cache = std::make_unique<ThreadCache>();
+        cache->freeNodes.reserve(NODE_BATCH_SIZE * 2);
+
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        t_cache = cache.get();
+        t_cacheOwner = m_instanceId;
+        m_threadCaches.push_back(std::move(cache));
+    }
+
+    return *static_cast<ThreadCache*>(t_cache);
+}
+
+EventNode* EventSystem::AcquireNode() {
+    ThreadCache& cache = GetThreadCache();
+
+    if (cache.freeNodes.empty()) {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+
+        if (m_freeNodes.empty()) {
+            // Grow the pool by one chunk; steady state never reaches this
+            m_nodeChunks.push_back(std::make_unique<EventNode[]>(NODE_BATCH_SIZE));
+            EventNode* chunk = m_nodeChunks.back().get();
+            for (size_t i = 0; i < NODE_BATCH_SIZE; ++i) {
+                cache.freeNodes.push_back(&chunk[i]);
+            }
+        } else {
+            size_t count = std::min(NODE_BATCH_SIZE, m_freeNodes.size());
+            cache.freeNodes.insert(cache.freeNodes.end(), m_freeNodes.end() - count, m_freeNodes.end());
+            m_freeNodes.resize(m_freeNodes.size() - count);
+        }
+    }
+
+    EventNode* node = cache.freeNodes.back();
+    cache.freeNodes.pop_back();
+    return node;
+}
+
+void EventSystem::ReleaseNode(EventNode* node) {
+    ThreadCache& cache = GetThreadCache();
+    cache.freeNodes.push_back(node);
+
+    // The dispatching thread frees every node; hand surplus back to producers
+    if (cache.freeNodes.size() >= NODE_BATCH_SIZE * 2) {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        m_freeNodes.insert(m_freeNodes.end(), cache.freeNodes.end() - NODE_BATCH_SIZE, cache.freeNodes.end());
+        cache.freeNodes.resize(cache.freeNodes.size() - NODE_BATCH_SIZE);
+    }
+}
+
+void EventSystem::DestroyEvent(EventNode* node) {
+    if (node->inlineStorage) {
+        node->event->~Event();
+    } else {
+        delete node->event;
+    }
+    node->event = nullptr;
+}
+
+void EventSystem::Enqueue(EventNode* node, EventTypeId typeId, EventTypeState* state, EventTiming timing) {
+    node->typeId = typeId;
+    node->typeState = state;
+    node->deferFrames = timing == EventTiming::NextFrame ? 1 : 0;
+
+    EventLane lane = state ? state->policy.lane : EventLane::Normal;
+    EventQueue& queue = GetThreadCache().staging[static_cast<size_t>(lane)];
+
+    if (state && state->policy.delivery == EventDelivery::Coalesce) {
+        // Push under the lock so the node is never visible to mergers before it is queued
+        std::lock_guard<std::mutex> lock(state->coalesceMutex);
+        if (!state->pendingNode) {
+            state->pendingNode = node;
+        }
+        queue.Push(node);
+    } else {
+        queue.Push(node);
+    }
+
+    // After the push: a drain racing with us costs at most one extra busy update
+    m_eventsQueued.store(true, std::memory_order_release);
+
+    // The dispatch thread is awake by definition; others may find it idle
+    if (m_wake && !IsDispatchThread()) {
+        m_wake();
+    }
+}
+
+void EventSystem::DiscardQueuedEvents() {
+    for (auto& deferred : m_deferredNodes) {
+        for (EventNode* node : deferred) {
+            BeginDispatch(node);
+            RetireNode(node);
+        }
+        deferred.clear();
+    }
+
+    std::vector<ThreadCache*> producers;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        for (const auto& cache : m_threadCaches) {
+            producers.push_back(cache.get());
+        }
+    }
+
+    for (ThreadCache* producer : producers) {
+        for (EventQueue& queue : producer->staging) {
+            while (EventNode* node = queue.Pop()) {
+                BeginDispatch(node);
+                RetireNode(node);
+            }
+        }
+    }
+}
+
+EventTypeState* EventSystem::GetTypeState(EventTypeId typeId) const {
+    if (typeId >= MAX_POLICY_TYPES) {
+        return nullptr;
+    }
+    return m_typeStates[typeId].load(std::memory_order_acquire);
+}
+
+void EventSystem::InstallTypeState(EventTypeId typeId, std::unique_ptr<EventTypeState> state) {
+    if (typeId >= MAX_POLICY_TYPES) {
+        std::cerr << "EventSystem: too many event types for policies, using default delivery" << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_policyMutex);
+
+    // Carry the counters over so stats survive a policy change
+    if (EventTypeState* previous = m_typeStates[typeId].load(std::memory_order_acquire)) {
+        state->coalesced.store(previous->coalesced.load());
+        state->dropped.store(previous->dropped.load());
+    }
+
+    m_typeStates[typeId].store(state.get(), std::memory_order_release);
+    m_ownedTypeStates.push_back(std::move(state));
+}
+
+EventTypeStats EventSystem::GetTypeStats(EventTypeId typeId) const {
+    EventTypeStats stats;
+    if (EventTypeState* state = GetTypeState(typeId)) {
+        stats.coalesced = state->coalesced.load(std::memory_order_relaxed);
+        stats.dropped = state->dropped.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+bool EventSystem::AbsorbEvent(EventTypeState& state, const Event& event) {
+    switch (state.policy.delivery) {
+        case EventDelivery::Coalesce: {
+            std::lock_guard<std::mutex> lock(state.coalesceMutex);
+            if (!state.pendingNode) {
+                return false;
+            }
+            state.merge(*state.pendingNode->event, event);
+            state.coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        case EventDelivery::Bounded: {
+            // Drop the newest event rather than evicting a queued one, which keeps publishing lock-free
+            if (state.inFlight.fetch_add(1, std::memory_order_acq_rel) >= state.policy.capacity) {
+                state.inFlight.fetch_sub(1, std::memory_order_acq_rel);
+                state.dropped.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+        case EventDelivery::Queue:
+        default:
+            return false;
+    }
+}
+
+void EventSystem::BeginDispatch(EventNode* node) {
+    EventTypeState* state = node->typeState;
+    if (state && state->policy.delivery == EventDelivery::Coalesce) {
+        // From here on the event is frozen; later publishes start a new pending node
+        std::lock_guard<std::mutex> lock(state->coalesceMutex);
+        if (state->pendingNode == node) {
+            state->pendingNode = nullptr;
+        }
+    }
+}
+
+void EventSystem::RetireNode(EventNode* node) {
+    EventTypeState* state = node->typeState;
+    if (state && state->policy.delivery == EventDelivery::Bounded) {
+        state->inFlight.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    node->typeState = nullptr;
+    DestroyEvent(node);
+    ReleaseNode(node);
 }
\ No newline at end of file
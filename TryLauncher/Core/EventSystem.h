@@ -1,14 +1,20 @@
 #pragma once
 
 #include "../Engine/Engine.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <vector>
-#include <queue>
-#include <mutex>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <string>
+#include <thread>
+#include <typeindex>
 #include <typeinfo>
-#include <unordered_map>
+#include <type_traits>
+#include <vector>
 
 class Event {
 public:
@@ -16,6 +22,111 @@ public:
     virtual std::string GetType() const = 0;
 };
 
+// Dense per-type index used to bucket handlers
+using EventTypeId = uint32_t;
+
+class EventTypeRegistry {
+public:
+    static EventTypeId Register(const std::type_index& type);
+    // Returns false for types nobody has subscribed to or published yet
+    static bool Find(const std::type_index& type, EventTypeId& outId);
+};
+
+// Assigned once per type on first use; afterwards a lookup is a single static load
+template<typename T>
+EventTypeId GetEventTypeId() {
+    static const EventTypeId id = EventTypeRegistry::Register(std::type_index(typeid(T)));
+    return id;
+}
+
+// How published events of one type reach the queue
+enum class EventDelivery {
+    Queue,      // Every event is queued (default)
+    Coalesce,   // At most one pending event per frame; later ones are merged into it
+    Bounded     // At most `capacity` pending events; further ones are dropped and counted
+};
+
+// Dispatch lanes, drained in order: High is always processed before Normal
+enum class EventLane : uint8_t {
+    High = 0,
+    Normal = 1
+};
+
+// Which frame boundary a published event is delivered at
+enum class EventTiming {
+    Immediate,   // Dispatched before Publish returns when called on the dispatch thread; EndOfFrame otherwise
+    EndOfFrame,  // Dispatched by the next ProcessEvents (default)
+    NextFrame    // Held back for one ProcessEvents and dispatched by the one after
+};
+
+struct EventPolicy {
+    EventDelivery delivery = EventDelivery::Queue;
+    EventLane lane = EventLane::Normal;
+    size_t capacity = 0; // Bounded only
+};
+
+struct EventTypeStats {
+    uint64_t coalesced = 0;
+    uint64_t dropped = 0;
+};
+
+struct EventTypeState;
+class EventSystem;
+
+// RAII handle returned by EventSystem::Subscribe; destroying or resetting it removes the
+// handler. Safe to destroy after the EventSystem itself, and from inside a handler.
+class EventSubscription {
+public:
+    EventSubscription() = default;
+    ~EventSubscription();
+
+    EventSubscription(EventSubscription&& other) noexcept;
+    EventSubscription& operator=(EventSubscription&& other) noexcept;
+    EventSubscription(const EventSubscription&) = delete;
+    EventSubscription& operator=(const EventSubscription&) = delete;
+
+    void Reset();
+    bool IsActive() const { return m_id != 0 && !m_owner.expired(); }
+
+private:
+    friend class EventSystem;
+    EventSubscription(std::weak_ptr<EventSystem*> owner, EventTypeId typeId, uint64_t id)
+        : m_owner(std::move(owner)), m_typeId(typeId), m_id(id) {}
+
+    std::weak_ptr<EventSystem*> m_owner;
+    EventTypeId m_typeId = 0;
+    uint64_t m_id = 0;
+};
+
+// Pooled storage for one queued event. Events up to INLINE_STORAGE_SIZE bytes are
+// constructed in place; larger ones fall back to the heap.
+struct EventNode {
+    static constexpr size_t INLINE_STORAGE_SIZE = 128;
+
+    std::atomic<EventNode*> next{nullptr};
+    Event* event = nullptr;
+    EventTypeId typeId = 0;
+    EventTypeState* typeState = nullptr; // Policy the event was admitted under, null for the default
+    uint8_t deferFrames = 0;             // ProcessEvents calls to skip before dispatch
+    bool inlineStorage = false;
+    alignas(std::max_align_t) unsigned char storage[INLINE_STORAGE_SIZE];
+};
+
+// Intrusive multi-producer/single-consumer queue (Vyukov). Push is wait-free
+// for producers; Pop is only called from the dispatching thread.
+class EventQueue {
+public:
+    EventQueue();
+
+    void Push(EventNode* node);
+    EventNode* Pop();
+
+private:
+    std::atomic<EventNode*> m_head;
+    EventNode* m_tail;
+    EventNode m_stub;
+};
+
 class EventSystem : public IEngineModule {
 public:
     EventSystem();
@@ -27,47 +138,212 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "EventSystem"; }
     int GetInitializationOrder() const override { return 100; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::MainThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override { access.Exclusive(); } // Handlers may touch any module
+    // Busy while events are queued or were dispatched last update, so the frame after
+    // an input event always runs
+    double GetIdleTimeout() const override;
 
-    // Event handling
+    // Event handling. Subscribe, Unsubscribe and ProcessEvents belong to the thread that
+    // initialized the system; Publish may be called from any thread. The handler stays
+    // registered for as long as the returned subscription is alive.
+    //
+    // Ordering: each thread stages its events in its own queue. ProcessEvents splices the
+    // queues lane by lane in the order the threads first published, so a frame's dispatch
+    // order depends only on what each thread published, not on how they interleaved.
+    // Immediate events bypass the delivery policy of their type.
     template<typename T>
-    void Subscribe(std::function<void(const T&)> handler);
-    
+    [[nodiscard]] EventSubscription Subscribe(std::function<void(const T&)> handler);
+
     template<typename T>
-    void Publish(const T& event);
-    
-    void PublishEvent(std::unique_ptr<Event> event);
-    
+    void Publish(const T& event, EventTiming timing = EventTiming::EndOfFrame);
+
+    void PublishEvent(std::unique_ptr<Event> event, EventTiming timing = EventTiming::EndOfFrame);
+
     void ProcessEvents();
 
+    // Called after another thread stages an event, so a main loop idling in WaitEvents
+    // dispatches it without waiting out its timeout. Set during initialization, before
+    // other threads publish; it must be safe to call from any thread.
+    void SetWakeCallback(std::function<void()> wake) { m_wake = std::move(wake); }
+
+    // Per-type delivery policy. Set these during initialization; replacing a policy
+    // while the type is being published is safe but events already queued keep the old one.
+    // For Coalesce, `merge` folds a newer event into the pending one (default: keep the latest).
+    template<typename T>
+    void SetEventPolicy(const EventPolicy& policy, std::function<void(T& pending, const T& latest)> merge = nullptr);
+
+    template<typename T>
+    EventTypeStats GetEventTypeStats() const;
+
+    size_t GetHandlerCount() const { return m_liveHandlerCount; }
+
 private:
-    struct EventHandler {
-        std::function<void(const Event&)> handler;
-        std::string eventType;
+    friend class EventSubscription;
+
+    using EventHandler = std::function<void(const Event&)>;
+
+    struct HandlerEntry {
+        uint64_t id = 0;   // 0 once unsubscribed; the slot is reclaimed by CompactHandlers
+        EventHandler handler;
+    };
+
+    static constexpr size_t NODE_BATCH_SIZE = 64;
+    static constexpr size_t LANE_COUNT = 2;
+    // Policies are looked up lock-free by type id; ids past this use the default policy
+    static constexpr size_t MAX_POLICY_TYPES = 256;
+
+    // Per-thread free nodes and staging queues so publishing never contends with other
+    // producers. Caches outlive their threads so late events are still delivered.
+    struct ThreadCache {
+        std::vector<EventNode*> freeNodes;
+        std::array<EventQueue, LANE_COUNT> staging; // Indexed by EventLane
     };
-    
-    std::vector<EventHandler> m_handlers;
-    std::queue<std::unique_ptr<Event>> m_eventQueue;
-    std::mutex m_queueMutex;
+
+    ThreadCache& GetThreadCache();
+    EventNode* AcquireNode();
+    void ReleaseNode(EventNode* node);
+    void DestroyEvent(EventNode* node);
+    void Enqueue(EventNode* node, EventTypeId typeId, EventTypeState* state, EventTiming timing);
+    bool IsDispatchThread() const { return std::this_thread::get_id() == m_dispatchThread; }
+    void DispatchToHandlers(EventTypeId typeId, const Event& event);
+    void DiscardQueuedEvents();
+
+    template<typename T>
+    EventNode* CreateNode(const T& event);
+
+    EventTypeState* GetTypeState(EventTypeId typeId) const;
+    void InstallTypeState(EventTypeId typeId, std::unique_ptr<EventTypeState> state);
+    EventTypeStats GetTypeStats(EventTypeId typeId) const;
+    // Returns true when the event was merged or dropped and must not be queued
+    bool AbsorbEvent(EventTypeState& state, const Event& event);
+    // Detaches a popped node from its policy before dispatch
+    void BeginDispatch(EventNode* node);
+    void RetireNode(EventNode* node);
+
+    EventSubscription AddHandler(EventTypeId typeId, EventHandler handler);
+    void Unsubscribe(EventTypeId typeId, uint64_t id);
+    // Applies subscriptions made during dispatch and drops unsubscribed slots
+    void CompactHandlers();
+
+    // Handlers bucketed by EventTypeId. While dispatching, buckets are only appended to
+    // via m_pendingHandlers and removals leave a tombstone, so iteration stays valid.
+    std::vector<std::vector<HandlerEntry>> m_handlers;
+    std::vector<std::pair<EventTypeId, HandlerEntry>> m_pendingHandlers;
+    std::vector<EventTypeId> m_dirtyBuckets;
+    uint64_t m_nextHandlerId = 1;
+    size_t m_liveHandlerCount = 0;
+    bool m_dispatching = false;
+    // Subscriptions hold a weak reference so they can tell whether we are still alive
+    std::shared_ptr<EventSystem*> m_self;
+
+    std::vector<EventNode*> m_dispatchBatch;
+    // NextFrame events held back by the previous ProcessEvents, per lane
+    std::array<std::vector<EventNode*>, LANE_COUNT> m_deferredNodes;
+    std::vector<ThreadCache*> m_producerSnapshot;
+    std::thread::id m_dispatchThread;
+    // Set by every Enqueue and immediate dispatch; ProcessEvents moves it to m_dispatchedLastUpdate
+    std::atomic<bool> m_eventsQueued{false};
+    bool m_dispatchedLastUpdate = false;
+    std::function<void()> m_wake;
+
+    // Type states are never freed before destruction, so publishers may hold on to
+    // a pointer after the slot has been replaced
+    std::array<std::atomic<EventTypeState*>, MAX_POLICY_TYPES> m_typeStates;
+    mutable std::mutex m_policyMutex;
+    std::vector<std::unique_ptr<EventTypeState>> m_ownedTypeStates;
+
+    // Node pool: chunks are only freed on destruction; free nodes move between
+    // the shared list and the thread caches in NODE_BATCH_SIZE batches
+    std::mutex m_poolMutex;
+    std::vector<std::unique_ptr<EventNode[]>> m_nodeChunks;
+    std::vector<EventNode*> m_freeNodes;
+    std::vector<std::unique_ptr<ThreadCache>> m_threadCaches;
+    const uint64_t m_instanceId;
+
     bool m_initialized = false;
 };
 
+struct EventTypeState {
+    EventPolicy policy;
+    std::function<void(Event& pending, const Event& latest)> merge;
+
+    // Coalesce: the queued node later events are merged into
+    std::mutex coalesceMutex;
+    EventNode* pendingNode = nullptr;
+
+    // Bounded: events admitted but not yet dispatched
+    std::atomic<size_t> inFlight{0};
+
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
 // Template implementations
 template<typename T>
-void EventSystem::Subscribe(std::function<void(const T&)> handler) {
-    EventHandler eventHandler;
-    eventHandler.eventType = typeid(T).name();
-    eventHandler.handler = [handler](const Event& event) {
-        const T* typedEvent = dynamic_cast<const T*>(&event);
-        if (typedEvent) {
-            handler(*typedEvent);
+EventSubscription EventSystem::Subscribe(std::function<void(const T&)> handler) {
+    // The bucket guarantees the dynamic type, so no dynamic_cast is needed
+    return AddHandler(GetEventTypeId<T>(), [handler = std::move(handler)](const Event& event) {
+        handler(static_cast<const T&>(event));
+    });
+}
+
+template<typename T>
+void EventSystem::Publish(const T& event, EventTiming timing) {
+    static_assert(std::is_base_of<Event, T>::value, "Published types must derive from Event");
+
+    EventTypeId typeId = GetEventTypeId<T>();
+    if (timing == EventTiming::Immediate && IsDispatchThread()) {
+        DispatchToHandlers(typeId, event);
+        // Handlers may have changed what is on screen; keep the next update busy
+        m_eventsQueued.store(true, std::memory_order_release);
+        return;
+    }
+
+    EventTypeState* state = GetTypeState(typeId);
+    if (state && AbsorbEvent(*state, event)) {
+        return;
+    }
+
+    Enqueue(CreateNode(event), typeId, state, timing);
+}
+
+template<typename T>
+EventNode* EventSystem::CreateNode(const T& event) {
+    EventNode* node = AcquireNode();
+    if constexpr (sizeof(T) <= EventNode::INLINE_STORAGE_SIZE && alignof(T) <= alignof(std::max_align_t)) {
+        node->event = new (node->storage) T(event);
+        node->inlineStorage = true;
+    } else {
+        node->event = new T(event);
+        node->inlineStorage = false;
+    }
+    return node;
+}
+
+template<typename T>
+void EventSystem::SetEventPolicy(const EventPolicy& policy, std::function<void(T& pending, const T& latest)> merge) {
+    static_assert(std::is_base_of<Event, T>::value, "Policies apply to types derived from Event");
+
+    auto state = std::make_unique<EventTypeState>();
+    state->policy = policy;
+
+    if (policy.delivery == EventDelivery::Coalesce) {
+        if (merge) {
+            state->merge = [merge = std::move(merge)](Event& pending, const Event& latest) {
+                merge(static_cast<T&>(pending), static_cast<const T&>(latest));
+            };
+        } else {
+            state->merge = [](Event& pending, const Event& latest) {
+                static_cast<T&>(pending) = static_cast<const T&>(latest);
+            };
         }
-    };
-    
-    m_handlers.push_back(eventHandler);
+    }
+
+    InstallTypeState(GetEventTypeId<T>(), std::move(state));
 }
 
 template<typename T>
-void EventSystem::Publish(const T& event) {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    m_eventQueue.push(std::make_unique<T>(event));
+EventTypeStats EventSystem::GetEventTypeStats() const {
+    return GetTypeStats(GetEventTypeId<T>());
 }
\ No newline at end of file
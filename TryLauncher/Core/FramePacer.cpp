@@ -0,0 +1,248 @@
+#include "FramePacer.h"
+#include "SettingsManager.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+namespace {
+    // Largest frame delta fed into the fixed-step accumulator (e.g. after a breakpoint or window drag)
+    constexpr double MAX_ACCUMULATED_DELTA = 0.25;
+
+    // Smoothing factors for the moving averages
+    constexpr float FRAME_TIME_SMOOTHING = 0.1f;
+    constexpr double SLEEP_SMOOTHING = 0.05;
+
+    float ToSeconds(FramePacer::Clock::duration duration) {
+        return std::chrono::duration<float>(duration).count();
+    }
+}
+
+FramePacer::FramePacer(SettingsManager* settingsManager)
+    : m_settingsManager(settingsManager) {
+}
+
+FramePacer::~FramePacer() {
+    if (m_initialized) {
+        Shutdown();
+    }
+}
+
+bool FramePacer::Initialize() {
+    if (m_initialized) {
+        return true;
+    }
+
+    std::cout << "Initializing FramePacer..." << std::endl;
+
+#ifdef _WIN32
+    // Default scheduler granularity is ~15.6 ms, which makes every sleep overshoot a whole frame
+    timeBeginPeriod(1);
+#endif
+
+    m_initialized = true;
+
+    if (m_settingsManager) {
+        ApplyPerformanceSettings(m_settingsManager->GetConfig().performance);
+    } else {
+        SetTargetFrameRate(m_targetFrameRate);
+    }
+
+    std::cout << "FramePacer initialized successfully" << std::endl;
+    return true;
+}
+
+void FramePacer::Update(float deltaTime) {
+    // Timing is driven by Engine::Run through BeginFrame/StepFixedUpdate/EndFrame
+}
+
+void FramePacer::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    std::cout << "Shutting down FramePacer..." << std::endl;
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+
+    m_firstFrame = true;
+    m_accumulator = 0.0;
+
+    m_initialized = false;
+    std::cout << "FramePacer shutdown complete" << std::endl;
+}
+
+float FramePacer::BeginFrame() {
+    Clock::time_point now = Clock::now();
+
+    float deltaTime = 0.0f;
+    if (m_firstFrame) {
+        m_nextDeadline = now + m_framePeriod;
+        m_firstFrame = false;
+    } else {
+        deltaTime = ToSeconds(now - m_frameStart);
+    }
+    m_frameStart = now;
+
+    // Frame statistics
+    m_stats.frameIndex++;
+    m_stats.frameTime = deltaTime;
+    if (m_stats.averageFrameTime <= 0.0f) {
+        m_stats.averageFrameTime = deltaTime;
+    } else {
+        m_stats.averageFrameTime += (deltaTime - m_stats.averageFrameTime) * FRAME_TIME_SMOOTHING;
+    }
+    m_stats.framesPerSecond = m_stats.averageFrameTime > 0.0f ? 1.0f / m_stats.averageFrameTime : 0.0f;
+    m_stats.fixedSteps = 0;
+    m_stats.droppedFixedSteps = 0;
+
+    m_accumulator += std::min(static_cast<double>(deltaTime), MAX_ACCUMULATED_DELTA);
+    m_fixedStepsThisFrame = 0;
+
+    return deltaTime;
+}
+
+bool FramePacer::StepFixedUpdate() {
+    if (m_accumulator < m_fixedTimestep) {
+        return false;
+    }
+
+    if (m_fixedStepsThisFrame >= m_maxFixedStepsPerFrame) {
+        // Too far behind to catch up: drop whole steps instead of spiralling
+        m_stats.droppedFixedSteps += static_cast<uint32_t>(m_accumulator / m_fixedTimestep);
+        m_accumulator = std::fmod(m_accumulator, static_cast<double>(m_fixedTimestep));
+        return false;
+    }
+
+    m_accumulator -= m_fixedTimestep;
+    m_fixedStepsThisFrame++;
+    m_stats.fixedSteps = m_fixedStepsThisFrame;
+    return true;
+}
+
+void FramePacer::EndFrame() {
+    Clock::time_point workEnd = Clock::now();
+    m_stats.workTime = ToSeconds(workEnd - m_frameStart);
+    m_stats.waitTime = 0.0f;
+    m_stats.idleTime = 0.0f;
+
+    if (m_targetFrameRate == 0) {
+        return;
+    }
+
+    // Deadlines advance by whole periods so rounding never accumulates into drift.
+    // If we fell more than a frame behind, resynchronise instead of bursting to catch up.
+    if (workEnd > m_nextDeadline + m_framePeriod) {
+        m_nextDeadline = workEnd;
+    }
+
+    WaitUntil(m_nextDeadline);
+    m_nextDeadline += m_framePeriod;
+
+    m_stats.waitTime = ToSeconds(Clock::now() - workEnd);
+}
+
+void FramePacer::ResumeAfterIdle() {
+    Clock::time_point now = Clock::now();
+    Clock::time_point idleStart = m_frameStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(m_stats.workTime + m_stats.waitTime));
+    m_stats.idleTime = ToSeconds(now - idleStart);
+
+    // Pretend the previous frame began one frame ago so nothing downstream simulates
+    // the idle time, and restart the deadline schedule from here
+    Clock::duration lastFrame = m_framePeriod;
+    if (lastFrame == Clock::duration::zero()) {
+        lastFrame = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(m_stats.frameTime));
+    }
+    m_frameStart = now - lastFrame;
+    m_nextDeadline = now + m_framePeriod;
+}
+
+void FramePacer::SetTargetFrameRate(uint32_t framesPerSecond) {
+    framesPerSecond = std::min(framesPerSecond, EngineConfig::Performance::MAX_TARGET_FRAME_RATE);
+    m_targetFrameRate = framesPerSecond;
+
+    if (framesPerSecond == 0) {
+        m_framePeriod = Clock::duration::zero();
+    } else {
+        m_framePeriod = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / framesPerSecond));
+    }
+
+    // Restart the deadline schedule from the current frame
+    m_nextDeadline = m_frameStart + m_framePeriod;
+}
+
+void FramePacer::SetFixedUpdateRate(uint32_t updatesPerSecond) {
+    updatesPerSecond = std::clamp(updatesPerSecond,
+        EngineConfig::Performance::MIN_FIXED_UPDATE_RATE,
+        EngineConfig::Performance::MAX_FIXED_UPDATE_RATE);
+    m_fixedTimestep = 1.0f / static_cast<float>(updatesPerSecond);
+}
+
+float FramePacer::GetFixedUpdateAlpha() const {
+    return static_cast<float>(m_accumulator / m_fixedTimestep);
+}
+
+void FramePacer::ApplyPerformanceSettings(const EngineConfig::Performance& performance) {
+    if (!m_initialized) {
+        return;
+    }
+
+    SetTargetFrameRate(performance.targetFrameRate);
+    SetFixedUpdateRate(performance.fixedUpdateRate);
+    SetMaxFixedStepsPerFrame(performance.maxFixedStepsPerFrame);
+
+    std::cout << "Frame pacing: target " << (m_targetFrameRate == 0 ? std::string("uncapped") : std::to_string(m_targetFrameRate) + " FPS")
+              << ", fixed step " << m_fixedTimestep * 1000.0f << " ms" << std::endl;
+}
+
+void FramePacer::OnSettingsChanged(const std::string& settingName) {
+    if (!m_initialized || !m_settingsManager) {
+        return;
+    }
+
+    if (settingName.find("performance.") == 0) {
+        ApplyPerformanceSettings(m_settingsManager->GetConfig().performance);
+    }
+}
+
+void FramePacer::WaitUntil(Clock::time_point deadline) {
+    // Coarse phase: sleep in 1 ms slices while the remaining time comfortably exceeds
+    // the measured cost of one slice, learning the scheduler's overshoot as we go
+    while (true) {
+        Clock::time_point sleepStart = Clock::now();
+        double remaining = std::chrono::duration<double>(deadline - sleepStart).count();
+        if (remaining <= m_sleepEstimate) {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        RecordSleepSample(std::chrono::duration<double>(Clock::now() - sleepStart).count());
+    }
+
+    // Fine phase: spin out the remainder
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::RecordSleepSample(double observedSeconds) {
+    double delta = observedSeconds - m_sleepMean;
+    m_sleepMean += delta * SLEEP_SMOOTHING;
+    m_sleepVariance = (1.0 - SLEEP_SMOOTHING) * (m_sleepVariance + delta * delta * SLEEP_SMOOTHING);
+
+    // Budget one standard deviation above the mean so late wakeups are rare
+    m_sleepEstimate = m_sleepMean + std::sqrt(m_sleepVariance);
+    m_stats.sleepOvershoot = static_cast<float>(std::max(0.0, m_sleepMean - 0.001));
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../Engine/Engine.h"
+#include "EngineConfig.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+class SettingsManager;
+
+// Timing information for the most recently completed frame
+struct FrameStats {
+    uint64_t frameIndex = 0;
+    float frameTime = 0.0f;         // Wall time between the starts of the last two frames (seconds)
+    float workTime = 0.0f;          // Time spent updating before the pacing wait
+    float waitTime = 0.0f;          // Time spent in the pacing wait
+    float idleTime = 0.0f;          // Time spent blocked on events after the frame (idleWhenStatic)
+    float sleepOvershoot = 0.0f;    // Current estimate of how far a 1 ms sleep overshoots
+    float averageFrameTime = 0.0f;  // Exponential moving average of frameTime
+    float framesPerSecond = 0.0f;   // Derived from averageFrameTime
+    uint32_t fixedSteps = 0;        // Fixed updates executed during the frame
+    uint32_t droppedFixedSteps = 0; // Fixed updates discarded to avoid a catch-up spiral
+};
+
+/**
+ * FramePacer drives the timing of Engine::Run.
+ * This class handles:
+ * - Pacing frames to a configurable target rate (0 = uncapped)
+ * - A fixed-timestep accumulator for simulation updates
+ * - Hybrid sleep + spin waiting with measured oversleep compensation
+ * - Per-frame timing statistics
+ * - Resuming cleanly after the engine idled on events, without a catch-up burst
+ */
+class FramePacer : public IEngineModule {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer(SettingsManager* settingsManager);
+    ~FramePacer();
+
+    // IEngineModule interface
+    bool Initialize() override;
+    void Update(float deltaTime) override;
+    void Shutdown() override;
+    const char* GetName() const override { return "FramePacer"; }
+    int GetInitializationOrder() const override { return 150; }
+
+    // Frame loop
+    float BeginFrame();
+    bool StepFixedUpdate();
+    void EndFrame();
+    // Call after blocking between frames; the next frame's delta excludes the idle time
+    void ResumeAfterIdle();
+
+    // Configuration
+    void SetTargetFrameRate(uint32_t framesPerSecond);
+    uint32_t GetTargetFrameRate() const { return m_targetFrameRate; }
+    void SetFixedUpdateRate(uint32_t updatesPerSecond);
+    float GetFixedTimestep() const { return m_fixedTimestep; }
+    void SetMaxFixedStepsPerFrame(uint32_t maxSteps) { m_maxFixedStepsPerFrame = maxSteps > 0 ? maxSteps : 1; }
+
+    // Fraction of a fixed step left in the accumulator, for render interpolation
+    float GetFixedUpdateAlpha() const;
+    const FrameStats& GetFrameStats() const { return m_stats; }
+
+    // Settings application
+    void ApplyPerformanceSettings(const EngineConfig::Performance& performance);
+    void OnSettingsChanged(const std::string& settingName);
+
+private:
+    void WaitUntil(Clock::time_point deadline);
+    void RecordSleepSample(double observedSeconds);
+
+    SettingsManager* m_settingsManager;
+    bool m_initialized = false;
+
+    // Configuration
+    uint32_t m_targetFrameRate = 60;
+    Clock::duration m_framePeriod = Clock::duration::zero();
+    float m_fixedTimestep = 1.0f / 60.0f;
+    uint32_t m_maxFixedStepsPerFrame = 5;
+
+    // Frame timing
+    Clock::time_point m_frameStart;
+    Clock::time_point m_nextDeadline;
+    bool m_firstFrame = true;
+    double m_accumulator = 0.0;
+    uint32_t m_fixedStepsThisFrame = 0;
+
+    // Observed duration of a 1 ms sleep (exponential moving mean/variance)
+    double m_sleepMean = 0.002;
+    double m_sleepVariance = 0.0;
+    double m_sleepEstimate = 0.002;
+
+    FrameStats m_stats;
+};
\ No newline at end of file
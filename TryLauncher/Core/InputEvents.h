@@ -67,6 +67,14 @@ public:
     double GetDeltaX() const { return m_deltaX; }
     double GetDeltaY() const { return m_deltaY; }
 
+    // Coalescing: keep the latest position and sum the movement in between
+    void Accumulate(const MouseMoveEvent& later) {
+        m_xpos = later.m_xpos;
+        m_ypos = later.m_ypos;
+        m_deltaX += later.m_deltaX;
+        m_deltaY += later.m_deltaY;
+    }
+
 private:
     double m_xpos;
     double m_ypos;
@@ -84,6 +92,12 @@ public:
     double GetXOffset() const { return m_xoffset; }
     double GetYOffset() const { return m_yoffset; }
 
+    // Coalescing: scroll offsets add up
+    void Accumulate(const MouseScrollEvent& later) {
+        m_xoffset += later.m_xoffset;
+        m_yoffset += later.m_yoffset;
+    }
+
 private:
     double m_xoffset;
     double m_yoffset;
@@ -35,6 +35,8 @@ bool InputManager::Initialize() {
         return false;
     }
     
+    ConfigureEventPolicies();
+    
     m_initialized = true;
     std::cout << "InputManager initialized" << std::endl;
     return true;
@@ -45,10 +47,8 @@ void InputManager::Update(float deltaTime) {
         return;
     }
     
-    // Poll GLFW events
-    if (m_window) {
-        glfwPollEvents();
-    }
+    // GLFW events are pumped once per frame by VulkanRenderer::Update on the main
+    // thread; the GLFW callbacks publish into the EventSystem from there
 }
 
 void InputManager::Shutdown() {
@@ -74,6 +74,30 @@ void InputManager::Shutdown() {
     std::cout << "InputManager shutdown complete" << std::endl;
 }
 
+void InputManager::ConfigureEventPolicies() {
+    // High-rate devices (1000 Hz mice, smooth scrolling) collapse to one event per frame
+    EventPolicy coalesced;
+    coalesced.delivery = EventDelivery::Coalesce;
+    m_eventSystem->SetEventPolicy<MouseMoveEvent>(coalesced,
+        [](MouseMoveEvent& pending, const MouseMoveEvent& latest) { pending.Accumulate(latest); });
+    m_eventSystem->SetEventPolicy<MouseScrollEvent>(coalesced,
+        [](MouseScrollEvent& pending, const MouseScrollEvent& latest) { pending.Accumulate(latest); });
+    
+    // Discrete input must never be starved by motion events
+    EventPolicy priority;
+    priority.lane = EventLane::High;
+    m_eventSystem->SetEventPolicy<KeyEvent>(priority);
+    m_eventSystem->SetEventPolicy<CharEvent>(priority);
+    m_eventSystem->SetEventPolicy<MouseButtonEvent>(priority);
+    m_eventSystem->SetEventPolicy<WindowCloseEvent>(priority);
+    
+    // Only the final size of a resize drag matters
+    EventPolicy resize;
+    resize.delivery = EventDelivery::Coalesce;
+    resize.lane = EventLane::High;
+    m_eventSystem->SetEventPolicy<WindowResizeEvent>(resize);
+}
+
 void InputManager::SetWindow(GLFWwindow* window) {
     m_window = window;
     
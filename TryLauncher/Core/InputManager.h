@@ -24,6 +24,8 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "InputManager"; }
     int GetInitializationOrder() const override { return 200; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::AnyThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override { access.Writes(GetName()); }
 
     // GLFW window setup
     void SetWindow(GLFWwindow* window);
@@ -47,6 +49,9 @@ private:
     static void WindowSizeCallback(GLFWwindow* window, int width, int height);
     static void WindowCloseCallback(GLFWwindow* window);
 
+    // Delivery policies for the events published below
+    void ConfigureEventPolicies();
+
     // Internal event handling
     void HandleKeyEvent(int key, int scancode, int action, int mods);
     void HandleMouseButtonEvent(int button, int action, int mods);
@@ -0,0 +1,330 @@
+#include "JobSystem.h"
+#include "SettingsManager.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace {
+    // Identifies which queue the current thread owns
+    thread_local JobSystem* t_jobSystem = nullptr;
+    thread_local int t_threadIndex = -1;
+}
+
+JobSystem::JobSystem(SettingsManager* settingsManager)
+    : m_settingsManager(settingsManager) {
+}
+
+JobSystem::~JobSystem() {
+    if (m_initialized) {
+        Shutdown();
+    }
+}
+
+bool JobSystem::Initialize() {
+    if (m_initialized) {
+        return true;
+    }
+
+    std::cout << "Initializing JobSystem..." << std::endl;
+
+    uint32_t workerCount = m_settingsManager ? m_settingsManager->GetConfig().performance.workerThreadCount : 0;
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    // The initializing thread becomes queue 0 so it can help while waiting
+    t_jobSystem = this;
+    t_threadIndex = 0;
+
+    m_stopping = false;
+    m_queues.clear();
+    for (uint32_t i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_initialized = true;
+
+    for (uint32_t i = 1; i <= workerCount; ++i) {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<int>(i));
+    }
+
+    std::cout << "JobSystem initialized with " << workerCount << " worker thread(s)" << std::endl;
+    return true;
+}
+
+void JobSystem::Update(float deltaTime) {
+    // Workers run continuously; nothing to do per frame
+}
+
+void JobSystem::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    std::cout << "Shutting down JobSystem..." << std::endl;
+
+    // Workers drain every queued job before exiting
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+
+    // Anything left belongs to queue 0 or was injected with no workers to run it
+    while (RunPendingJob()) {
+    }
+
+    m_initialized = false;
+    m_queues.clear();
+
+    if (t_jobSystem == this) {
+        t_jobSystem = nullptr;
+        t_threadIndex = -1;
+    }
+
+    std::cout << "JobSystem shutdown complete" << std::endl;
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> work) {
+    auto job = CreateJob(std::move(work));
+    JobHandle handle(job);
+    ReleaseDependency(job);
+    return handle;
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> work, std::initializer_list<JobHandle> dependencies) {
+    auto job = CreateJob(std::move(work));
+    for (const auto& dependency : dependencies) {
+        AddDependency(job, dependency);
+    }
+
+    JobHandle handle(job);
+    ReleaseDependency(job);
+    return handle;
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies) {
+    auto job = CreateJob(std::move(work));
+    for (const auto& dependency : dependencies) {
+        AddDependency(job, dependency);
+    }
+
+    JobHandle handle(job);
+    ReleaseDependency(job);
+    return handle;
+}
+
+JobHandle JobSystem::ParallelFor(size_t begin, size_t end, size_t grainSize, RangeFunction body,
+                                 const std::vector<JobHandle>& dependencies) {
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    auto parent = CreateJob(nullptr);
+    Job* parentJob = parent.get();
+    auto sharedBody = std::make_shared<RangeFunction>(std::move(body));
+
+    // The parent fans out the chunks when it runs, so the range respects its dependencies.
+    // Each chunk holds a reference on the parent until it finishes.
+    parent->work = [this, parentJob, begin, end, grainSize, sharedBody]() {
+        for (size_t chunkBegin = begin; chunkBegin < end;) {
+            size_t chunkEnd = chunkBegin + std::min(grainSize, end - chunkBegin);
+
+            auto child = CreateJob([sharedBody, chunkBegin, chunkEnd]() { (*sharedBody)(chunkBegin, chunkEnd); });
+            child->parent = parentJob->shared_from_this();
+            parentJob->unfinished.fetch_add(1, std::memory_order_relaxed);
+            ReleaseDependency(child);
+
+            chunkBegin = chunkEnd;
+        }
+    };
+
+    for (const auto& dependency : dependencies) {
+        AddDependency(parent, dependency);
+    }
+
+    JobHandle handle(parent);
+    ReleaseDependency(parent);
+    return handle;
+}
+
+void JobSystem::Wait(const JobHandle& handle) {
+    while (!handle.IsComplete()) {
+        if (!RunPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::RunPendingJob() {
+    int threadIndex = (t_jobSystem == this) ? t_threadIndex : -1;
+
+    auto job = FindJob(threadIndex);
+    if (!job) {
+        return false;
+    }
+
+    Execute(job);
+    return true;
+}
+
+int JobSystem::GetCurrentThreadIndex() {
+    return t_threadIndex;
+}
+
+std::shared_ptr<Job> JobSystem::CreateJob(std::function<void()> work) {
+    auto job = std::make_shared<Job>();
+    job->work = std::move(work);
+    return job;
+}
+
+void JobSystem::AddDependency(const std::shared_ptr<Job>& job, const JobHandle& dependency) {
+    if (!dependency.m_job) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(dependency.m_job->continuationMutex);
+    if (!dependency.m_job->completed) {
+        job->unmetDependencies.fetch_add(1, std::memory_order_relaxed);
+        dependency.m_job->continuations.push_back(job);
+    }
+}
+
+void JobSystem::ReleaseDependency(const std::shared_ptr<Job>& job) {
+    if (job->unmetDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        Enqueue(job);
+    }
+}
+
+void JobSystem::Enqueue(std::shared_ptr<Job> job) {
+    if (!m_initialized) {
+        // Before startup or after shutdown jobs simply run inline
+        Execute(job);
+        return;
+    }
+
+    WorkQueue& queue = (t_jobSystem == this) ? *m_queues[t_threadIndex] : m_injectionQueue;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+        m_queuedJobs.fetch_add(1, std::memory_order_release);
+    }
+
+    {
+        // Pairs with the predicate check in WorkerLoop so a wakeup cannot be lost
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+}
+
+std::shared_ptr<Job> JobSystem::FindJob(int threadIndex) {
+    auto takeJob = [this](WorkQueue& queue, bool newest) -> std::shared_ptr<Job> {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return nullptr;
+        }
+
+        std::shared_ptr<Job> job;
+        if (newest) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    };
+
+    // Own queue first, newest job first for cache locality
+    if (threadIndex >= 0 && threadIndex < static_cast<int>(m_queues.size())) {
+        if (auto job = takeJob(*m_queues[threadIndex], true)) {
+            return job;
+        }
+    }
+
+    if (auto job = takeJob(m_injectionQueue, false)) {
+        return job;
+    }
+
+    // Steal the oldest job from the other queues, starting after our own
+    size_t queueCount = m_queues.size();
+    size_t start = threadIndex >= 0 ? static_cast<size_t>(threadIndex) + 1 : 0;
+    for (size_t i = 0; i < queueCount; ++i) {
+        size_t victim = (start + i) % queueCount;
+        if (static_cast<int>(victim) == threadIndex) {
+            continue;
+        }
+
+        if (auto job = takeJob(*m_queues[victim], false)) {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::Execute(const std::shared_ptr<Job>& job) {
+    if (job->work) {
+        try {
+            job->work();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Job failed: " << e.what() << std::endl;
+        }
+        // Release captured state as soon as the work is done
+        job->work = nullptr;
+    }
+
+    Finish(job);
+}
+
+void JobSystem::Finish(const std::shared_ptr<Job>& job) {
+    if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<Job>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->continuationMutex);
+        job->completed = true;
+        continuations.swap(job->continuations);
+    }
+    job->done.store(true, std::memory_order_release);
+
+    for (const auto& continuation : continuations) {
+        ReleaseDependency(continuation);
+    }
+
+    if (job->parent) {
+        std::shared_ptr<Job> parent = std::move(job->parent);
+        Finish(parent);
+    }
+}
+
+void JobSystem::WorkerLoop(int threadIndex) {
+    t_jobSystem = this;
+    t_threadIndex = threadIndex;
+
+    while (true) {
+        if (auto job = FindJob(threadIndex)) {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this] {
+            return m_stopping.load() || m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+
+        if (m_stopping.load() && m_queuedJobs.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "../Engine/Engine.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class SettingsManager;
+
+// Internal job record; owned through JobHandle and the scheduler queues
+struct Job : public std::enable_shared_from_this<Job> {
+    std::function<void()> work;
+    std::shared_ptr<Job> parent;
+
+    // Runs once this reaches zero: one guard reference plus one per incomplete dependency
+    std::atomic<uint32_t> unmetDependencies{1};
+    // Completes once this reaches zero: the job itself plus one per unfinished child
+    std::atomic<uint32_t> unfinished{1};
+    std::atomic<bool> done{false};
+
+    std::mutex continuationMutex;
+    std::vector<std::shared_ptr<Job>> continuations;
+    bool completed = false;     // Guarded by continuationMutex
+};
+
+// Reference to a scheduled job, usable as a dependency or waited on
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    bool IsValid() const { return m_job != nullptr; }
+    bool IsComplete() const { return !m_job || m_job->done.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+    explicit JobHandle(std::shared_ptr<Job> job) : m_job(std::move(job)) {}
+
+    std::shared_ptr<Job> m_job;
+};
+
+/**
+ * JobSystem is the engine's shared worker pool.
+ * This class handles:
+ * - Per-worker job deques with work stealing between workers
+ * - Job handles with dependency counters and continuations
+ * - Parallel-for over index ranges
+ * - Letting waiting threads execute pending jobs instead of blocking
+ */
+class JobSystem : public IEngineModule {
+public:
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    JobSystem(SettingsManager* settingsManager);
+    ~JobSystem();
+
+    // IEngineModule interface
+    bool Initialize() override;
+    void Update(float deltaTime) override;
+    void Shutdown() override;
+    const char* GetName() const override { return "JobSystem"; }
+    int GetInitializationOrder() const override { return 110; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::AnyThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override { access.Writes(GetName()); }
+
+    // Job submission. Jobs run once every dependency has completed.
+    JobHandle Schedule(std::function<void()> work);
+    JobHandle Schedule(std::function<void()> work, std::initializer_list<JobHandle> dependencies);
+    JobHandle Schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies);
+
+    // Splits [begin, end) into chunks of at most grainSize; the handle completes after every chunk
+    JobHandle ParallelFor(size_t begin, size_t end, size_t grainSize, RangeFunction body,
+                          const std::vector<JobHandle>& dependencies = {});
+
+    // Blocks until the job completes, executing other pending jobs meanwhile
+    void Wait(const JobHandle& handle);
+    // Runs one pending job on the calling thread; returns false if none was available
+    bool RunPendingJob();
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    // 0 for the thread that initialized the system, 1..N for workers, -1 for any other thread
+    static int GetCurrentThreadIndex();
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Job>> jobs;
+    };
+
+    std::shared_ptr<Job> CreateJob(std::function<void()> work);
+    void AddDependency(const std::shared_ptr<Job>& job, const JobHandle& dependency);
+    void ReleaseDependency(const std::shared_ptr<Job>& job);
+    void Enqueue(std::shared_ptr<Job> job);
+    std::shared_ptr<Job> FindJob(int threadIndex);
+    void Execute(const std::shared_ptr<Job>& job);
+    void Finish(const std::shared_ptr<Job>& job);
+    void WorkerLoop(int threadIndex);
+
+    SettingsManager* m_settingsManager;
+    bool m_initialized = false;
+
+    // Queue 0 belongs to the owning (main) thread, 1..N to the workers
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    // Submissions from threads the system does not own
+    WorkQueue m_injectionQueue;
+    std::vector<std::thread> m_workers;
+
+    // Sleeping workers wait here until a job is queued
+    std::atomic<uint32_t> m_queuedJobs{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<bool> m_stopping{false};
+};
\ No newline at end of file
@@ -21,7 +21,7 @@ bool NavigationManager::Initialize() {
     std::cout << "Initializing NavigationManager..." << std::endl;
     
     // Subscribe to navigation events
-    m_eventSystem->Subscribe<NavigationEvent>(
+    m_navigationSubscription = m_eventSystem->Subscribe<NavigationEvent>(
         [this](const NavigationEvent& event) {
             OnNavigationEvent(event);
         });
@@ -52,6 +52,9 @@ void NavigationManager::Shutdown() {
     
     std::cout << "Shutting down NavigationManager..." << std::endl;
     
+    // Stop receiving navigation events
+    m_navigationSubscription.Reset();
+    
     // Clear navigation stack
     while (!m_navigationStack.empty()) {
         m_navigationStack.pop();
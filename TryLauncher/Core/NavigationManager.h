@@ -39,6 +39,10 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "NavigationManager"; }
     int GetInitializationOrder() const override { return 700; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::AnyThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override { access.Writes(GetName()); }
+    // A running transition animates every frame
+    double GetIdleTimeout() const override { return m_transitionEffect ? 0.0 : IEngineModule::GetIdleTimeout(); }
 
     // Navigation methods
     void NavigateTo(const std::string& sceneName, 
@@ -55,6 +59,7 @@ private:
     
     SceneManager* m_sceneManager;
     EventSystem* m_eventSystem;
+    EventSubscription m_navigationSubscription;
     
     std::stack<std::string> m_navigationStack;
     std::unique_ptr<TransitionEffect> m_transitionEffect;
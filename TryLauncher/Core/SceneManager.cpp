@@ -35,6 +35,28 @@ void SceneManager::Update(float deltaTime) {
     UpdateCurrentScene(deltaTime);
 }
 
+void SceneManager::FixedUpdate(float fixedDeltaTime) {
+    if (!m_initialized || !m_currentScene) {
+        return;
+    }
+    
+    m_currentScene->FixedUpdate(fixedDeltaTime);
+}
+
+void SceneManager::DeclareUpdateAccess(ModuleAccess& access) const {
+    access.Writes(GetName());
+    // Scenes drive their UI documents directly
+    access.Writes("RmlUISystem");
+}
+
+double SceneManager::GetIdleTimeout() const {
+    if (!m_initialized || !m_currentScene) {
+        return IEngineModule::GetIdleTimeout();
+    }
+    
+    return m_currentScene->GetIdleTimeout();
+}
+
 void SceneManager::Shutdown() {
     if (!m_initialized) {
         return;
@@ -13,10 +13,16 @@ public:
     virtual ~Scene() = default;
     virtual bool Initialize() = 0;
     virtual void Update(float deltaTime) = 0;
+    virtual void FixedUpdate(float fixedDeltaTime) {}
     virtual void Render() = 0;
     virtual void Cleanup() = 0;
     virtual void OnEnter() {}
     virtual void OnExit() {}
+    
+    // Seconds until the scene next needs an update without input. Scenes that
+    // simulate every frame keep the default; static menus return infinity so the
+    // engine can idle (see IEngineModule::GetIdleTimeout).
+    virtual double GetIdleTimeout() const { return 0.0; }
 };
 
 class SceneManager : public IEngineModule {
@@ -27,9 +33,13 @@ public:
     // IEngineModule interface
     bool Initialize() override;
     void Update(float deltaTime) override;
+    void FixedUpdate(float fixedDeltaTime) override;
     void Shutdown() override;
     const char* GetName() const override { return "SceneManager"; }
     int GetInitializationOrder() const override { return 600; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::MainThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override;
+    double GetIdleTimeout() const override;
 
     // Scene management
     void RegisterScene(const std::string& name, std::unique_ptr<Scene> scene);
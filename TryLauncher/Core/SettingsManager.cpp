@@ -115,12 +115,19 @@ T SettingsManager::GetSetting(const std::string& key, const T& defaultValue) con
         if (key == "graphics.windowWidth") return static_cast<T>(m_config.graphics.windowWidth);
         if (key == "graphics.windowHeight") return static_cast<T>(m_config.graphics.windowHeight);
         if (key == "graphics.msaaSamples") return static_cast<T>(m_config.graphics.msaaSamples);
+        if (key == "graphics.framesInFlight") return static_cast<T>(m_config.graphics.framesInFlight);
+        if (key == "performance.targetFrameRate") return static_cast<T>(m_config.performance.targetFrameRate);
+        if (key == "performance.fixedUpdateRate") return static_cast<T>(m_config.performance.fixedUpdateRate);
+        if (key == "performance.maxFixedStepsPerFrame") return static_cast<T>(m_config.performance.maxFixedStepsPerFrame);
+        if (key == "performance.workerThreadCount") return static_cast<T>(m_config.performance.workerThreadCount);
     }
     
     if constexpr (std::is_same_v<T, bool>) {
         if (key == "graphics.fullscreen") return static_cast<T>(m_config.graphics.fullscreen);
         if (key == "graphics.vsync") return static_cast<T>(m_config.graphics.vsync);
+        if (key == "graphics.lowLatency") return static_cast<T>(m_config.graphics.lowLatency);
         if (key == "graphics.enableValidation") return static_cast<T>(m_config.graphics.enableValidation);
+        if (key == "performance.idleWhenStatic") return static_cast<T>(m_config.performance.idleWhenStatic);
     }
     
     // Audio settings
@@ -134,6 +141,7 @@ T SettingsManager::GetSetting(const std::string& key, const T& defaultValue) con
     // String settings
     if constexpr (std::is_same_v<T, std::string>) {
         if (key == "graphics.preferredGPU") return m_config.graphics.preferredGPU;
+        if (key == "graphics.presentMode") return m_config.graphics.presentMode;
         if (key == "audio.audioDevice") return m_config.audio.audioDevice;
         if (key == "assetPath") return m_config.assetPath;
         if (key == "configPath") return m_config.configPath;
@@ -177,6 +185,55 @@ bool SettingsManager::SetSetting(const std::string& key, const T& value) {
                 changed = true;
             }
         }
+        else if (key == "graphics.framesInFlight") {
+            uint32_t newVal = static_cast<uint32_t>(value);
+            if (newVal >= EngineConfig::Graphics::MIN_FRAMES_IN_FLIGHT &&
+                newVal <= EngineConfig::Graphics::MAX_FRAMES_IN_FLIGHT) {
+                oldValue = static_cast<int>(m_config.graphics.framesInFlight);
+                m_config.graphics.framesInFlight = newVal;
+                newValue = static_cast<int>(newVal);
+                changed = true;
+            }
+        }
+        // Performance settings - integers
+        else if (key == "performance.targetFrameRate") {
+            uint32_t newVal = static_cast<uint32_t>(value);
+            if (newVal == 0 || (newVal >= EngineConfig::Performance::MIN_TARGET_FRAME_RATE &&
+                                newVal <= EngineConfig::Performance::MAX_TARGET_FRAME_RATE)) {
+                oldValue = static_cast<int>(m_config.performance.targetFrameRate);
+                m_config.performance.targetFrameRate = newVal;
+                newValue = static_cast<int>(newVal);
+                changed = true;
+            }
+        }
+        else if (key == "performance.fixedUpdateRate") {
+            uint32_t newVal = static_cast<uint32_t>(value);
+            if (newVal >= EngineConfig::Performance::MIN_FIXED_UPDATE_RATE &&
+                newVal <= EngineConfig::Performance::MAX_FIXED_UPDATE_RATE) {
+                oldValue = static_cast<int>(m_config.performance.fixedUpdateRate);
+                m_config.performance.fixedUpdateRate = newVal;
+                newValue = static_cast<int>(newVal);
+                changed = true;
+            }
+        }
+        else if (key == "performance.maxFixedStepsPerFrame") {
+            uint32_t newVal = static_cast<uint32_t>(value);
+            if (newVal >= 1 && newVal <= EngineConfig::Performance::MAX_FIXED_STEPS_PER_FRAME) {
+                oldValue = static_cast<int>(m_config.performance.maxFixedStepsPerFrame);
+                m_config.performance.maxFixedStepsPerFrame = newVal;
+                newValue = static_cast<int>(newVal);
+                changed = true;
+            }
+        }
+        else if (key == "performance.workerThreadCount") {
+            uint32_t newVal = static_cast<uint32_t>(value);
+            if (newVal <= EngineConfig::Performance::MAX_WORKER_THREADS) {
+                oldValue = static_cast<int>(m_config.performance.workerThreadCount);
+                m_config.performance.workerThreadCount = newVal;
+                newValue = static_cast<int>(newVal);
+                changed = true;
+            }
+        }
     }
     
     // Graphics settings - booleans
@@ -193,12 +250,24 @@ bool SettingsManager::SetSetting(const std::string& key, const T& value) {
             newValue = value;
             changed = true;
         }
+        else if (key == "graphics.lowLatency") {
+            oldValue = m_config.graphics.lowLatency;
+            m_config.graphics.lowLatency = value;
+            newValue = value;
+            changed = true;
+        }
         else if (key == "graphics.enableValidation") {
             oldValue = m_config.graphics.enableValidation;
             m_config.graphics.enableValidation = value;
             newValue = value;
             changed = true;
         }
+        else if (key == "performance.idleWhenStatic") {
+            oldValue = m_config.performance.idleWhenStatic;
+            m_config.performance.idleWhenStatic = value;
+            newValue = value;
+            changed = true;
+        }
     }
     
     // Audio settings - floats
@@ -249,6 +318,14 @@ bool SettingsManager::SetSetting(const std::string& key, const T& value) {
             newValue = value;
             changed = true;
         }
+        else if (key == "graphics.presentMode") {
+            if (EngineConfig::Graphics::IsValidPresentMode(value)) {
+                oldValue = m_config.graphics.presentMode;
+                m_config.graphics.presentMode = value;
+                newValue = value;
+                changed = true;
+            }
+        }
         else if (key == "audio.audioDevice") {
             oldValue = m_config.audio.audioDevice;
             m_config.audio.audioDevice = value;
@@ -383,6 +460,9 @@ bool SettingsManager::SaveToTextFile(const std::string& path) const {
         file << "graphics.windowHeight=" << m_config.graphics.windowHeight << "\n";
         file << "graphics.fullscreen=" << (m_config.graphics.fullscreen ? "true" : "false") << "\n";
         file << "graphics.vsync=" << (m_config.graphics.vsync ? "true" : "false") << "\n";
+        file << "graphics.presentMode=" << m_config.graphics.presentMode << "\n";
+        file << "graphics.framesInFlight=" << m_config.graphics.framesInFlight << "\n";
+        file << "graphics.lowLatency=" << (m_config.graphics.lowLatency ? "true" : "false") << "\n";
         file << "graphics.msaaSamples=" << m_config.graphics.msaaSamples << "\n";
         file << "graphics.enableValidation=" << (m_config.graphics.enableValidation ? "true" : "false") << "\n";
         file << "graphics.preferredGPU=" << m_config.graphics.preferredGPU << "\n";
@@ -401,6 +481,13 @@ bool SettingsManager::SaveToTextFile(const std::string& path) const {
             file << "input.keyBinding." << binding.first << "=" << binding.second << "\n";
         }
         
+        file << "# Performance Settings\n";
+        file << "performance.targetFrameRate=" << m_config.performance.targetFrameRate << "\n";
+        file << "performance.fixedUpdateRate=" << m_config.performance.fixedUpdateRate << "\n";
+        file << "performance.maxFixedStepsPerFrame=" << m_config.performance.maxFixedStepsPerFrame << "\n";
+        file << "performance.workerThreadCount=" << m_config.performance.workerThreadCount << "\n";
+        file << "performance.idleWhenStatic=" << (m_config.performance.idleWhenStatic ? "true" : "false") << "\n";
+        
         file << "# General Settings\n";
         file << "assetPath=" << m_config.assetPath << "\n";
         file << "configPath=" << m_config.configPath << "\n";
@@ -449,6 +536,12 @@ bool SettingsManager::LoadFromTextFile(const std::string& path) {
                 newConfig.graphics.fullscreen = (value == "true");
             } else if (key == "graphics.vsync") {
                 newConfig.graphics.vsync = (value == "true");
+            } else if (key == "graphics.presentMode") {
+                newConfig.graphics.presentMode = value;
+            } else if (key == "graphics.framesInFlight") {
+                newConfig.graphics.framesInFlight = std::stoul(value);
+            } else if (key == "graphics.lowLatency") {
+                newConfig.graphics.lowLatency = (value == "true");
             } else if (key == "graphics.msaaSamples") {
                 newConfig.graphics.msaaSamples = std::stoul(value);
             } else if (key == "graphics.enableValidation") {
@@ -468,6 +561,16 @@ bool SettingsManager::LoadFromTextFile(const std::string& path) {
             } else if (key.substr(0, 18) == "input.keyBinding.") {
                 std::string bindingName = key.substr(18);
                 newConfig.input.keyBindings[bindingName] = std::stoi(value);
+            } else if (key == "performance.targetFrameRate") {
+                newConfig.performance.targetFrameRate = std::stoul(value);
+            } else if (key == "performance.fixedUpdateRate") {
+                newConfig.performance.fixedUpdateRate = std::stoul(value);
+            } else if (key == "performance.maxFixedStepsPerFrame") {
+                newConfig.performance.maxFixedStepsPerFrame = std::stoul(value);
+            } else if (key == "performance.workerThreadCount") {
+                newConfig.performance.workerThreadCount = std::stoul(value);
+            } else if (key == "performance.idleWhenStatic") {
+                newConfig.performance.idleWhenStatic = (value == "true");
             } else if (key == "assetPath") {
                 newConfig.assetPath = value;
             } else if (key == "configPath") {
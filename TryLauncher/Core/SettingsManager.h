@@ -36,6 +36,8 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "SettingsManager"; }
     int GetInitializationOrder() const override { return 200; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::AnyThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override { access.Writes(GetName()); }
 
     // Settings persistence (simplified for now)
     bool LoadSettings(const std::string& configPath = "");
@@ -9,13 +9,33 @@
 #include "../Core/SettingsManager.h"
 #include "../Audio/AudioManager.h"
 #include "../Core/InputManager.h"
+#include "../Core/FramePacer.h"
+#include "../Core/JobSystem.h"
+#include "ModuleScheduler.h"
 
 #include <algorithm>
-#include <chrono>
 #include <iostream>
-#include <thread>
 #include <unordered_map>
 
+bool ModuleAccess::ConflictsWith(const ModuleAccess& other) const {
+    if (m_exclusive || other.m_exclusive) {
+        return true;
+    }
+    
+    auto intersects = [](const std::vector<std::string>& a, const std::vector<std::string>& b) {
+        for (const auto& resource : a) {
+            if (std::find(b.begin(), b.end(), resource) != b.end()) {
+                return true;
+            }
+        }
+        return false;
+    };
+    
+    return intersects(m_writes, other.m_writes) ||
+           intersects(m_writes, other.m_reads) ||
+           intersects(m_reads, other.m_writes);
+}
+
 Engine::Engine() = default;
 
 Engine::~Engine() {
@@ -39,6 +59,11 @@ bool Engine::Initialize(const EngineConfig& config) {
             m_settingsManager->SetConfig(config);
         }
         
+        // Pick up frame pacing from the final configuration
+        if (m_framePacer) {
+            m_framePacer->ApplyPerformanceSettings(GetConfig().performance);
+        }
+        
         m_initialized = true;
         m_running = true;
         
@@ -58,19 +83,28 @@ void Engine::Run() {
         return;
     }
     
-    auto lastTime = std::chrono::high_resolution_clock::now();
-    
     while (m_running) {
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
-        lastTime = currentTime;
+        float deltaTime = m_framePacer->BeginFrame();
+        
+        // Simulation runs at a fixed rate, independent of the frame rate
+        while (m_framePacer->StepFixedUpdate()) {
+            FixedUpdateModules(m_framePacer->GetFixedTimestep());
+        }
         
-        // Update all modules
+        // Variable-rate update (UI, rendering)
         UpdateModules(deltaTime);
         
-        // Basic frame rate limiting (can be improved later)
-        if (deltaTime < 0.016f) { // ~60 FPS
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        // Wait out the rest of the frame budget
+        m_framePacer->EndFrame();
+        
+        // Nothing animates, loads or has input pending: sleep until an OS event
+        // arrives or a module's next deadline instead of producing identical frames
+        if (GetConfig().performance.idleWhenStatic) {
+            double idleTimeout = GetIdleTimeout();
+            if (idleTimeout >= MIN_IDLE_WAIT && m_running) {
+                m_renderer->WaitEvents(idleTimeout);
+                m_framePacer->ResumeAfterIdle();
+            }
         }
     }
 }
@@ -89,6 +123,15 @@ void Engine::Shutdown() {
     std::cout << "Engine shutdown complete" << std::endl;
 }
 
+const FrameStats& Engine::GetFrameStats() const {
+    if (m_framePacer) {
+        return m_framePacer->GetFrameStats();
+    }
+    
+    static FrameStats emptyStats;
+    return emptyStats;
+}
+
 const EngineConfig& Engine::GetConfig() const {
     if (m_settingsManager) {
         return m_settingsManager->GetConfig();
@@ -123,28 +166,44 @@ void Engine::InitializeModules() {
         throw std::runtime_error("Failed to initialize SettingsManager");
     }
     
+    // 2.5. Job System (depends on Settings for the worker count)
+    m_jobSystem = std::make_unique<JobSystem>(m_settingsManager.get());
+    if (!m_jobSystem->Initialize()) {
+        throw std::runtime_error("Failed to initialize JobSystem");
+    }
+    
+    // 2.6. Frame Pacer (depends on Settings)
+    m_framePacer = std::make_unique<FramePacer>(m_settingsManager.get());
+    if (!m_framePacer->Initialize()) {
+        throw std::runtime_error("Failed to initialize FramePacer");
+    }
+    
     // 3. Vulkan Renderer (depends on Settings)
     m_renderer = std::make_unique<VulkanRenderer>(m_settingsManager.get());
     if (!m_renderer->Initialize()) {
         throw std::runtime_error("Failed to initialize VulkanRenderer");
     }
+    // Events staged by workers end an idle wait instead of waiting out its timeout
+    m_eventSystem->SetWakeCallback(&VulkanRenderer::Wake);
     
     // 3.5. Resource Manager (depends on Vulkan Renderer)
     m_resourceManager = std::make_unique<ResourceManager>(m_renderer.get());
     if (!m_resourceManager->Initialize()) {
         throw std::runtime_error("Failed to initialize ResourceManager");
     }
+    m_renderer->SetResourceManager(m_resourceManager.get());
     
-    // 4. Asset Manager (depends on Renderer and ResourceManager)
-    m_assetManager = std::make_unique<AssetManager>(m_renderer.get(), m_resourceManager.get());
+    // 4. Asset Manager (depends on Renderer, ResourceManager and JobSystem)
+    m_assetManager = std::make_unique<AssetManager>(m_renderer.get(), m_resourceManager.get(), m_jobSystem.get());
     // Set the correct asset base path for the executable location
     m_assetManager->SetAssetBasePath("assets/");
     if (!m_assetManager->Initialize()) {
         throw std::runtime_error("Failed to initialize AssetManager");
     }
     
-    // 5. RmlUI System (depends on Renderer, ResourceManager, and AssetManager)
-    m_uiSystem = std::make_unique<RmlUISystem>(m_renderer.get(), m_assetManager.get(), m_resourceManager.get());
+    // 5. RmlUI System (depends on Renderer, ResourceManager, AssetManager and JobSystem)
+    m_uiSystem = std::make_unique<RmlUISystem>(m_renderer.get(), m_assetManager.get(), m_resourceManager.get(),
+                                               m_jobSystem.get());
     if (!m_uiSystem->Initialize()) {
         throw std::runtime_error("Failed to initialize RmlUISystem");
     }
@@ -187,6 +246,35 @@ void Engine::InitializeModules() {
     
     // Set up settings change callbacks after all modules are initialized
     SetupSettingsCallbacks();
+    
+    // Build the parallel update graph once the module set is final
+    BuildUpdateSchedule();
+}
+
+void Engine::BuildUpdateSchedule() {
+    m_moduleScheduler = std::make_unique<ModuleScheduler>();
+    if (!m_moduleScheduler->Initialize(m_jobSystem.get())) {
+        throw std::runtime_error("Failed to initialize ModuleScheduler");
+    }
+    
+    // Registration order decides which of two conflicting modules updates first
+    std::vector<IEngineModule*> updateOrder = {
+        m_eventSystem.get(),
+        m_settingsManager.get(),
+        m_renderer.get(),
+        m_resourceManager.get(),
+        m_assetManager.get(),
+        m_uiSystem.get(),
+        m_sceneManager.get(),
+        m_navigationManager.get(),
+        m_audioManager.get(),
+        m_inputManager.get()
+    };
+    for (auto& module : m_modules) {
+        updateOrder.push_back(module.get());
+    }
+    
+    m_moduleScheduler->Build(updateOrder);
 }
 
 void Engine::SetupSettingsCallbacks() {
@@ -216,6 +304,21 @@ void Engine::SetupSettingsCallbacks() {
                 m_renderer->OnSettingsChanged(key);
             });
         
+        m_settingsManager->RegisterChangeCallback("graphics.presentMode", 
+            [this](const std::string& key, const SettingsManager::SettingValue& value) {
+                m_renderer->OnSettingsChanged(key);
+            });
+        
+        m_settingsManager->RegisterChangeCallback("graphics.framesInFlight", 
+            [this](const std::string& key, const SettingsManager::SettingValue& value) {
+                m_renderer->OnSettingsChanged(key);
+            });
+        
+        m_settingsManager->RegisterChangeCallback("graphics.lowLatency", 
+            [this](const std::string& key, const SettingsManager::SettingValue& value) {
+                m_renderer->OnSettingsChanged(key);
+            });
+        
         m_settingsManager->RegisterChangeCallback("graphics.msaaSamples", 
             [this](const std::string& key, const SettingsManager::SettingValue& value) {
                 m_renderer->OnSettingsChanged(key);
@@ -245,6 +348,24 @@ void Engine::SetupSettingsCallbacks() {
             });
     }
     
+    // Register FramePacer for performance settings changes
+    if (m_framePacer) {
+        m_settingsManager->RegisterChangeCallback("performance.targetFrameRate", 
+            [this](const std::string& key, const SettingsManager::SettingValue& value) {
+                m_framePacer->OnSettingsChanged(key);
+            });
+        
+        m_settingsManager->RegisterChangeCallback("performance.fixedUpdateRate", 
+            [this](const std::string& key, const SettingsManager::SettingValue& value) {
+                m_framePacer->OnSettingsChanged(key);
+            });
+        
+        m_settingsManager->RegisterChangeCallback("performance.maxFixedStepsPerFrame", 
+            [this](const std::string& key, const SettingsManager::SettingValue& value) {
+                m_framePacer->OnSettingsChanged(key);
+            });
+    }
+    
     // Register InputManager for input settings changes
     if (m_inputManager) {
         m_settingsManager->RegisterChangeCallback("input.mouseSensitivity", 
@@ -257,25 +378,62 @@ void Engine::SetupSettingsCallbacks() {
 }
 
 void Engine::UpdateModules(float deltaTime) {
-    // Update core modules
-    if (m_eventSystem) m_eventSystem->Update(deltaTime);
-    if (m_settingsManager) m_settingsManager->Update(deltaTime);
-    if (m_renderer) m_renderer->Update(deltaTime);
-    if (m_resourceManager) m_resourceManager->Update(deltaTime);
-    if (m_assetManager) m_assetManager->Update(deltaTime);
-    if (m_uiSystem) m_uiSystem->Update(deltaTime);
-    if (m_sceneManager) m_sceneManager->Update(deltaTime);
-    if (m_navigationManager) m_navigationManager->Update(deltaTime);
-    if (m_audioManager) m_audioManager->Update(deltaTime);
-    if (m_inputManager) m_inputManager->Update(deltaTime);
-    
-    // Update additional modules
+    // Core and additional modules run as a dependency graph; see DeclareUpdateAccess
+    m_moduleScheduler->Update(deltaTime);
+}
+
+void Engine::FixedUpdateModules(float fixedDeltaTime) {
+    // Only the scene layer simulates today; every module gets the hook for consistency
+    if (m_eventSystem) m_eventSystem->FixedUpdate(fixedDeltaTime);
+    if (m_settingsManager) m_settingsManager->FixedUpdate(fixedDeltaTime);
+    if (m_renderer) m_renderer->FixedUpdate(fixedDeltaTime);
+    if (m_resourceManager) m_resourceManager->FixedUpdate(fixedDeltaTime);
+    if (m_assetManager) m_assetManager->FixedUpdate(fixedDeltaTime);
+    if (m_uiSystem) m_uiSystem->FixedUpdate(fixedDeltaTime);
+    if (m_sceneManager) m_sceneManager->FixedUpdate(fixedDeltaTime);
+    if (m_navigationManager) m_navigationManager->FixedUpdate(fixedDeltaTime);
+    if (m_audioManager) m_audioManager->FixedUpdate(fixedDeltaTime);
+    if (m_inputManager) m_inputManager->FixedUpdate(fixedDeltaTime);
+    
     for (auto& module : m_modules) {
-        module->Update(deltaTime);
+        module->FixedUpdate(fixedDeltaTime);
+    }
+}
+
+double Engine::GetIdleTimeout() const {
+    const IEngineModule* coreModules[] = {
+        m_eventSystem.get(),
+        m_settingsManager.get(),
+        m_renderer.get(),
+        m_resourceManager.get(),
+        m_assetManager.get(),
+        m_uiSystem.get(),
+        m_sceneManager.get(),
+        m_navigationManager.get(),
+        m_audioManager.get(),
+        m_inputManager.get()
+    };
+    
+    double timeout = MAX_IDLE_WAIT;
+    for (const IEngineModule* module : coreModules) {
+        if (module) {
+            timeout = std::min(timeout, module->GetIdleTimeout());
+        }
+    }
+    for (const auto& module : m_modules) {
+        timeout = std::min(timeout, module->GetIdleTimeout());
     }
+    
+    return timeout;
 }
 
 void Engine::ShutdownModules() {
+    // Stop the update workers before any module goes away
+    if (m_moduleScheduler) {
+        m_moduleScheduler->Shutdown();
+        m_moduleScheduler.reset();
+    }
+    
     // Shutdown additional modules first (reverse order)
     for (auto it = m_modules.rbegin(); it != m_modules.rend(); ++it) {
         (*it)->Shutdown();
@@ -314,6 +472,9 @@ void Engine::ShutdownModules() {
     }
     
     if (m_resourceManager) {
+        if (m_renderer) {
+            m_renderer->SetResourceManager(nullptr);
+        }
         m_resourceManager->Shutdown();
         m_resourceManager.reset();
     }
@@ -323,6 +484,17 @@ void Engine::ShutdownModules() {
         m_renderer.reset();
     }
     
+    if (m_framePacer) {
+        m_framePacer->Shutdown();
+        m_framePacer.reset();
+    }
+    
+    // Outlives every module that can submit work
+    if (m_jobSystem) {
+        m_jobSystem->Shutdown();
+        m_jobSystem.reset();
+    }
+    
     if (m_settingsManager) {
         m_settingsManager->Shutdown();
         m_settingsManager.reset();
@@ -6,6 +6,7 @@
 #include <functional>
 #include <unordered_map>
 #include <string>
+#include <limits>
 
 // Forward declarations
 class VulkanRenderer;
@@ -18,15 +19,58 @@ class SettingsManager;
 class ResourceManager;
 class AudioManager;
 class InputManager;
+class FramePacer;
+class JobSystem;
+class ModuleScheduler;
+struct FrameStats;
+
+// Which threads a module's Update may run on
+enum class ModuleThreadAffinity {
+    MainThread,     // Touches thread-bound APIs (GLFW, RmlUi) - always runs on the main thread
+    AnyThread       // May run on a worker when its dependencies allow it
+};
+
+// Shared state a module touches during Update. Resources are named by string;
+// by convention a module's own state is named after its GetName(). Two modules
+// conflict when either writes a resource the other reads or writes, and
+// conflicting modules keep their registration order.
+class ModuleAccess {
+public:
+    void Reads(const std::string& resource) { m_reads.push_back(resource); }
+    void Writes(const std::string& resource) { m_writes.push_back(resource); }
+    void Exclusive() { m_exclusive = true; }
+    
+    const std::vector<std::string>& GetReads() const { return m_reads; }
+    const std::vector<std::string>& GetWrites() const { return m_writes; }
+    bool IsExclusive() const { return m_exclusive; }
+    
+    bool ConflictsWith(const ModuleAccess& other) const;
+
+private:
+    std::vector<std::string> m_reads;
+    std::vector<std::string> m_writes;
+    bool m_exclusive = false;
+};
 
 class IEngineModule {
 public:
     virtual ~IEngineModule() = default;
     virtual bool Initialize() = 0;
     virtual void Update(float deltaTime) = 0;
+    virtual void FixedUpdate(float fixedDeltaTime) {}
     virtual void Shutdown() = 0;
     virtual const char* GetName() const = 0;
     virtual int GetInitializationOrder() const = 0;
+    
+    // Update scheduling. The defaults keep unannotated modules serialized
+    // against everything else on the main thread.
+    virtual ModuleThreadAffinity GetThreadAffinity() const { return ModuleThreadAffinity::MainThread; }
+    virtual void DeclareUpdateAccess(ModuleAccess& access) const { access.Exclusive(); }
+    
+    // Seconds until the module next has work to do without new input; 0 keeps the
+    // frame loop running. Engine::Run blocks for the smallest value across modules
+    // when idling is enabled, so animating or loading modules must return 0.
+    virtual double GetIdleTimeout() const { return std::numeric_limits<double>::infinity(); }
 };
 
 class Engine {
@@ -49,6 +93,11 @@ public:
     ResourceManager* GetResourceManager() const { return m_resourceManager.get(); }
     AudioManager* GetAudioManager() const { return m_audioManager.get(); }
     InputManager* GetInputManager() const { return m_inputManager.get(); }
+    FramePacer* GetFramePacer() const { return m_framePacer.get(); }
+    JobSystem* GetJobSystem() const { return m_jobSystem.get(); }
+    
+    // Timing of the last completed frame
+    const FrameStats& GetFrameStats() const;
     
     // Module registration
     void RegisterModule(std::unique_ptr<IEngineModule> module);
@@ -63,8 +112,16 @@ public:
 private:
     void InitializeModules();
     void SetupSettingsCallbacks();
+    void BuildUpdateSchedule();
     void UpdateModules(float deltaTime);
+    void FixedUpdateModules(float fixedDeltaTime);
     void ShutdownModules();
+    double GetIdleTimeout() const;
+    
+    // Idle waits are capped so polled state (gamepads, file watchers) is still seen,
+    // and skipped when too short to be worth giving up the frame
+    static constexpr double MAX_IDLE_WAIT = 0.5;
+    static constexpr double MIN_IDLE_WAIT = 0.001;
     
     bool m_running = false;
     bool m_initialized = false;
@@ -80,6 +137,9 @@ private:
     std::unique_ptr<SettingsManager> m_settingsManager;
     std::unique_ptr<AudioManager> m_audioManager;
     std::unique_ptr<InputManager> m_inputManager;
+    std::unique_ptr<FramePacer> m_framePacer;
+    std::unique_ptr<JobSystem> m_jobSystem;
+    std::unique_ptr<ModuleScheduler> m_moduleScheduler;
     
     // Additional modules
     std::vector<std::unique_ptr<IEngineModule>> m_modules;
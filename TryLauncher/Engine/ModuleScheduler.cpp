@@ -0,0 +1,170 @@
+#include "ModuleScheduler.h"
+#include "../Core/JobSystem.h"
+#include <exception>
+#include <iostream>
+#include <thread>
+
+ModuleScheduler::ModuleScheduler() = default;
+
+ModuleScheduler::~ModuleScheduler() {
+    if (m_initialized) {
+        Shutdown();
+    }
+}
+
+bool ModuleScheduler::Initialize(JobSystem* jobSystem) {
+    if (m_initialized) {
+        return true;
+    }
+
+    m_jobSystem = jobSystem;
+
+    m_initialized = true;
+    std::cout << "ModuleScheduler initialized (" << (IsParallel() ? "parallel" : "sequential") << " updates)" << std::endl;
+    return true;
+}
+
+void ModuleScheduler::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    // Dispatched jobs that found no node to run may still be queued
+    while (m_outstandingJobs.load() > 0) {
+        if (!m_jobSystem->RunPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    m_nodes.clear();
+    m_roots.clear();
+    m_jobSystem = nullptr;
+
+    m_initialized = false;
+}
+
+bool ModuleScheduler::IsParallel() const {
+    return m_jobSystem && m_jobSystem->GetWorkerCount() > 0;
+}
+
+void ModuleScheduler::Build(const std::vector<IEngineModule*>& modules) {
+    m_nodes.clear();
+    m_roots.clear();
+
+    std::vector<ModuleAccess> access(modules.size());
+    m_nodes.resize(modules.size());
+
+    for (size_t i = 0; i < modules.size(); ++i) {
+        m_nodes[i].module = modules[i];
+        m_nodes[i].affinity = modules[i]->GetThreadAffinity();
+        modules[i]->DeclareUpdateAccess(access[i]);
+    }
+
+    // Each module depends on every earlier module it conflicts with. Transitive
+    // edges are redundant but harmless for graphs of this size.
+    for (size_t i = 0; i < modules.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (access[i].ConflictsWith(access[j])) {
+                m_nodes[j].successors.push_back(static_cast<uint32_t>(i));
+                m_nodes[i].predecessorCount++;
+            }
+        }
+
+        if (m_nodes[i].predecessorCount == 0) {
+            m_roots.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void ModuleScheduler::Update(float deltaTime) {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_deltaTime = deltaTime;
+    m_completedNodes = 0;
+    for (auto& node : m_nodes) {
+        node.pendingPredecessors = node.predecessorCount;
+    }
+
+    for (uint32_t root : m_roots) {
+        MakeReady(root);
+    }
+
+    // The main thread runs pinned modules and takes worker-eligible ones itself
+    // whenever it would otherwise block, so a busy pool never stalls the frame
+    while (m_completedNodes < m_nodes.size()) {
+        uint32_t nodeIndex;
+        if (!m_mainReady.empty()) {
+            nodeIndex = m_mainReady.front();
+            m_mainReady.pop_front();
+        } else if (!m_workerReady.empty()) {
+            nodeIndex = m_workerReady.front();
+            m_workerReady.pop_front();
+        } else {
+            m_mainCondition.wait(lock);
+            continue;
+        }
+
+        lock.unlock();
+        RunNode(nodeIndex);
+        lock.lock();
+        CompleteNode(nodeIndex);
+    }
+}
+
+void ModuleScheduler::MakeReady(uint32_t nodeIndex) {
+    if (m_nodes[nodeIndex].affinity == ModuleThreadAffinity::MainThread || !IsParallel()) {
+        m_mainReady.push_back(nodeIndex);
+        return;
+    }
+
+    // Jobs pick whichever node is ready when they run rather than a fixed one
+    m_workerReady.push_back(nodeIndex);
+    m_outstandingJobs++;
+    m_jobSystem->Schedule([this]() {
+        RunWorkerNode();
+        m_outstandingJobs--;
+    });
+}
+
+void ModuleScheduler::RunWorkerNode() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_workerReady.empty()) {
+        return;
+    }
+
+    uint32_t nodeIndex = m_workerReady.front();
+    m_workerReady.pop_front();
+
+    lock.unlock();
+    RunNode(nodeIndex);
+    lock.lock();
+    CompleteNode(nodeIndex);
+}
+
+void ModuleScheduler::RunNode(uint32_t nodeIndex) {
+    IEngineModule* module = m_nodes[nodeIndex].module;
+
+    try {
+        module->Update(m_deltaTime);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Module '" << module->GetName() << "' update failed: " << e.what() << std::endl;
+    }
+}
+
+void ModuleScheduler::CompleteNode(uint32_t nodeIndex) {
+    for (uint32_t successor : m_nodes[nodeIndex].successors) {
+        if (--m_nodes[successor].pendingPredecessors == 0) {
+            MakeReady(successor);
+        }
+    }
+
+    m_completedNodes++;
+
+    // The main thread waits on either new work or the last completion
+    m_mainCondition.notify_one();
+}
\ No newline at end of file
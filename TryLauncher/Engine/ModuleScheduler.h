@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Engine.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+class JobSystem;
+
+/**
+ * ModuleScheduler runs module Update calls as a dependency graph.
+ * This class handles:
+ * - Building the graph from each module's declared ModuleAccess
+ * - Running independent AnyThread modules concurrently on JobSystem workers
+ * - Keeping MainThread modules on the calling thread
+ * - Preserving registration order between conflicting modules
+ */
+class ModuleScheduler {
+public:
+    ModuleScheduler();
+    ~ModuleScheduler();
+
+    // Without a JobSystem (or with no workers) the whole graph runs on the calling thread
+    bool Initialize(JobSystem* jobSystem);
+    void Shutdown();
+
+    // Modules are given in registration order, which breaks ties between conflicts
+    void Build(const std::vector<IEngineModule*>& modules);
+    void Update(float deltaTime);
+
+    bool IsParallel() const;
+
+private:
+    struct Node {
+        IEngineModule* module = nullptr;
+        ModuleThreadAffinity affinity = ModuleThreadAffinity::MainThread;
+        std::vector<uint32_t> successors;
+        uint32_t predecessorCount = 0;
+        uint32_t pendingPredecessors = 0;
+    };
+
+    void MakeReady(uint32_t nodeIndex);    // Called with m_mutex held
+    void RunWorkerNode();
+    void RunNode(uint32_t nodeIndex);
+    void CompleteNode(uint32_t nodeIndex);  // Called with m_mutex held
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_roots;
+
+    // Per-update state, guarded by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_mainCondition;
+    std::deque<uint32_t> m_mainReady;
+    std::deque<uint32_t> m_workerReady;
+    uint32_t m_completedNodes = 0;
+    float m_deltaTime = 0.0f;
+
+    JobSystem* m_jobSystem = nullptr;
+    std::atomic<uint32_t> m_outstandingJobs{0};
+    bool m_initialized = false;
+};
\ No newline at end of file
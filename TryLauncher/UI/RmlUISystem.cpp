@@ -10,6 +10,8 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <limits>
 
 // RmlUI System Interface implementation
 class RmlUISystem::SystemInterface : public Rml::SystemInterface {
@@ -101,8 +103,9 @@ public:
     }
 };
 
-RmlUISystem::RmlUISystem(VulkanRenderer* renderer, AssetManager* assetManager, ResourceManager* resourceManager)
-    : m_renderer(renderer), m_assetManager(assetManager), m_resourceManager(resourceManager) {
+RmlUISystem::RmlUISystem(VulkanRenderer* renderer, AssetManager* assetManager, ResourceManager* resourceManager,
+                         JobSystem* jobSystem)
+    : m_renderer(renderer), m_assetManager(assetManager), m_resourceManager(resourceManager), m_jobSystem(jobSystem) {
 }
 
 RmlUISystem::~RmlUISystem() {
@@ -126,7 +129,7 @@ bool RmlUISystem::Initialize() {
         }
         
         // Create Vulkan renderer
-        m_rmlRenderer = std::make_unique<VulkanRmlRenderer>(m_renderer, m_resourceManager);
+        m_rmlRenderer = std::make_unique<VulkanRmlRenderer>(m_renderer, m_resourceManager, m_jobSystem);
         if (!m_rmlRenderer->Initialize()) {
             std::cerr << "Failed to initialize VulkanRmlRenderer" << std::endl;
             return false;
@@ -163,8 +166,30 @@ void RmlUISystem::Update(float deltaTime) {
         return;
     }
     
-    // Update RmlUI context
-    m_context->Update();
+    // Update RmlUI contexts
+    for (Rml::Context* layer : m_layers) {
+        layer->Update();
+    }
+}
+
+void RmlUISystem::DeclareUpdateAccess(ModuleAccess& access) const {
+    access.Writes(GetName());
+    // Context updates can compile geometry and create textures through the render interface
+    access.Writes("ResourceManager");
+}
+
+double RmlUISystem::GetIdleTimeout() const {
+    if (!m_initialized || !m_context) {
+        return IEngineModule::GetIdleTimeout();
+    }
+    
+    // Animations, transitions and dirty layout request the next update through the context;
+    // a static document reports infinity
+    double delay = std::numeric_limits<double>::infinity();
+    for (Rml::Context* layer : m_layers) {
+        delay = std::min(delay, layer->GetNextUpdateDelay());
+    }
+    return delay;
 }
 
 void RmlUISystem::Shutdown() {
@@ -182,11 +207,12 @@ void RmlUISystem::Shutdown() {
     }
     m_loadedDocuments.clear();
     
-    // Cleanup context
-    if (m_context) {
-        Rml::RemoveContext(m_context->GetName());
-        m_context = nullptr;
+    // Cleanup contexts
+    for (Rml::Context* layer : m_layers) {
+        Rml::RemoveContext(layer->GetName());
     }
+    m_layers.clear();
+    m_context = nullptr;
     
     // Cleanup renderer
     if (m_rmlRenderer) {
@@ -279,9 +305,9 @@ void RmlUISystem::ProcessKeyEvent(int key, int action, int mods) {
     int rmlMods = ConvertKeyModifiers(mods);
     
     if (action == GLFW_PRESS) {
-        m_context->ProcessKeyDown(rmlKey, rmlMods);
+        DispatchTopDown([&](Rml::Context* layer) { return layer->ProcessKeyDown(rmlKey, rmlMods); });
     } else if (action == GLFW_RELEASE) {
-        m_context->ProcessKeyUp(rmlKey, rmlMods);
+        DispatchTopDown([&](Rml::Context* layer) { return layer->ProcessKeyUp(rmlKey, rmlMods); });
     }
 }
 
@@ -294,9 +320,9 @@ void RmlUISystem::ProcessMouseButtonEvent(int button, int action, int mods) {
     int rmlMods = ConvertKeyModifiers(mods);
     
     if (action == GLFW_PRESS) {
-        m_context->ProcessMouseButtonDown(rmlButton, rmlMods);
+        DispatchTopDown([&](Rml::Context* layer) { return layer->ProcessMouseButtonDown(rmlButton, rmlMods); });
     } else if (action == GLFW_RELEASE) {
-        m_context->ProcessMouseButtonUp(rmlButton, rmlMods);
+        DispatchTopDown([&](Rml::Context* layer) { return layer->ProcessMouseButtonUp(rmlButton, rmlMods); });
     }
 }
 
@@ -308,7 +334,10 @@ void RmlUISystem::ProcessMouseMoveEvent(double xpos, double ypos) {
     m_mouseX = xpos;
     m_mouseY = ypos;
     
-    m_context->ProcessMouseMove(static_cast<int>(xpos), static_cast<int>(ypos), 0);
+    // Every layer tracks the mouse so hover state stays right as it moves between them
+    for (Rml::Context* layer : m_layers) {
+        layer->ProcessMouseMove(static_cast<int>(xpos), static_cast<int>(ypos), 0);
+    }
 }
 
 void RmlUISystem::ProcessScrollEvent(double xoffset, double yoffset) {
@@ -316,7 +345,7 @@ void RmlUISystem::ProcessScrollEvent(double xoffset, double yoffset) {
         return;
     }
     
-    m_context->ProcessMouseWheel(static_cast<float>(-yoffset), 0);
+    DispatchTopDown([&](Rml::Context* layer) { return layer->ProcessMouseWheel(static_cast<float>(-yoffset), 0); });
 }
 
 void RmlUISystem::ProcessCharEvent(unsigned int codepoint) {
@@ -324,23 +353,42 @@ void RmlUISystem::ProcessCharEvent(unsigned int codepoint) {
         return;
     }
     
-    m_context->ProcessTextInput(codepoint);
+    DispatchTopDown([&](Rml::Context* layer) { return layer->ProcessTextInput(static_cast<Rml::Character>(codepoint)); });
 }
 
-void RmlUISystem::Render(VkCommandBuffer commandBuffer, VkRenderPass renderPass,
-                        uint32_t framebufferWidth, uint32_t framebufferHeight) {
+void RmlUISystem::Render(VkCommandBuffer commandBuffer, uint32_t framebufferWidth, uint32_t framebufferHeight) {
     if (!m_initialized || !m_context || !m_rmlRenderer) {
         return;
     }
     
     // Begin frame for renderer
-    m_rmlRenderer->BeginFrame(commandBuffer, renderPass, framebufferWidth, framebufferHeight);
+    m_rmlRenderer->BeginFrame(commandBuffer, framebufferWidth, framebufferHeight);
     
-    // Render context
-    m_context->Render();
+    // Layers are traversed here, since RmlUi is single-threaded; the renderer then records
+    // each one into its own secondary command buffer on the workers
+    for (size_t i = 0; i < m_layers.size(); ++i) {
+        if (i > 0) {
+            m_rmlRenderer->BeginLayer();
+        }
+        m_layers[i]->Render();
+    }
     
     // End frame
     m_rmlRenderer->EndFrame();
+
+    // Only the redrawn regions changed on screen, so the compositor need not copy the rest
+    if (VulkanSwapchain* swapchain = m_renderer->GetSwapchain()) {
+        swapchain->SetPresentRegions(m_rmlRenderer->GetDamage());
+    }
+}
+
+void RmlUISystem::Composite(VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+                            uint32_t framebufferWidth, uint32_t framebufferHeight) {
+    if (!m_initialized || !m_rmlRenderer) {
+        return;
+    }
+
+    m_rmlRenderer->Composite(commandBuffer, renderPass, framebufferWidth, framebufferHeight);
 }
 
 // Private helper methods
@@ -373,10 +421,49 @@ bool RmlUISystem::CreateContext() {
         std::cerr << "Failed to create RmlUI context" << std::endl;
         return false;
     }
+    m_layers.push_back(m_context);
     
     return true;
 }
 
+Rml::Context* RmlUISystem::CreateLayer(const std::string& name) {
+    if (!m_initialized || !m_context) {
+        return nullptr;
+    }
+    
+    if (Rml::Context* existing = GetLayer(name)) {
+        return existing;
+    }
+    
+    Rml::Context* layer = Rml::CreateContext(name, m_context->GetDimensions());
+    if (!layer) {
+        std::cerr << "Failed to create RmlUI layer: " << name << std::endl;
+        return nullptr;
+    }
+    
+    // Layers start out with the pointer where the main context last saw it
+    layer->ProcessMouseMove(static_cast<int>(m_mouseX), static_cast<int>(m_mouseY), 0);
+    m_layers.push_back(layer);
+    return layer;
+}
+
+Rml::Context* RmlUISystem::GetLayer(const std::string& name) const {
+    for (Rml::Context* layer : m_layers) {
+        if (layer->GetName() == name) {
+            return layer;
+        }
+    }
+    return nullptr;
+}
+
+void RmlUISystem::DispatchTopDown(const std::function<bool(Rml::Context*)>& handler) {
+    for (auto it = m_layers.rbegin(); it != m_layers.rend(); ++it) {
+        if (!handler(*it)) {
+            break;
+        }
+    }
+}
+
 void RmlUISystem::SetupEventHandlers() {
     // TODO: Set up event handlers for UI interactions
     // This will be implemented when we add navigation support
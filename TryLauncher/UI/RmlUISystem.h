@@ -3,26 +3,30 @@
 #include "../Engine/Engine.h"
 #include <RmlUi/Core.h>
 #include <vulkan/vulkan.h>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class VulkanRenderer;
 class AssetManager;
 class VulkanRmlRenderer;
 class ResourceManager;
+class JobSystem;
 
 /**
  * RmlUISystem manages the RmlUI integration with the Vulkan renderer.
  * This class handles:
  * - RmlUI initialization with custom Vulkan backend
- * - Context creation and document management
+ * - Context creation and document management, with extra contexts as layers drawn over the main one
  * - Font loading and management integration
  * - Input event processing and routing to RmlUI
  */
 class RmlUISystem : public IEngineModule {
 public:
-    RmlUISystem(VulkanRenderer* renderer, AssetManager* assetManager, ResourceManager* resourceManager);
+    RmlUISystem(VulkanRenderer* renderer, AssetManager* assetManager, ResourceManager* resourceManager,
+                JobSystem* jobSystem = nullptr);
     ~RmlUISystem();
 
     // IEngineModule interface
@@ -31,13 +35,19 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "RmlUISystem"; }
     int GetInitializationOrder() const override { return 500; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::MainThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override;
+    double GetIdleTimeout() const override;
 
     // RmlUI-specific methods
     bool LoadFont(const std::string& fontPath, const std::string& fontName);
     bool LoadStylesheet(const std::string& stylesheetPath);
     
-    // Context management
+    // Context management. The main context is the bottom layer; independent documents such as
+    // toasts or an overlay go in layers above it, which are recorded on worker threads in parallel.
     Rml::Context* GetContext() const { return m_context; }
+    Rml::Context* CreateLayer(const std::string& name);
+    Rml::Context* GetLayer(const std::string& name) const;
     
     // Document management
     Rml::ElementDocument* LoadDocument(const std::string& rmlPath);
@@ -55,9 +65,11 @@ public:
     void ProcessScrollEvent(double xoffset, double yoffset);
     void ProcessCharEvent(unsigned int codepoint);
     
-    // Rendering
-    void Render(VkCommandBuffer commandBuffer, VkRenderPass renderPass, 
-               uint32_t framebufferWidth, uint32_t framebufferHeight);
+    // Rendering. Render updates the UI's offscreen target outside any render pass and hands
+    // its damage to the swapchain's next present; Composite draws the target inside the frame's pass.
+    void Render(VkCommandBuffer commandBuffer, uint32_t framebufferWidth, uint32_t framebufferHeight);
+    void Composite(VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+                   uint32_t framebufferWidth, uint32_t framebufferHeight);
 
 private:
     // RmlUI system interface implementations
@@ -67,6 +79,8 @@ private:
     // Initialization helpers
     bool InitializeRmlUI();
     bool CreateContext();
+    // Offers an event to the layers from the top down until one consumes it (the handler returns false)
+    void DispatchTopDown(const std::function<bool(Rml::Context*)>& handler);
     void SetupEventHandlers();
     
     // Input conversion helpers
@@ -76,12 +90,14 @@ private:
     VulkanRenderer* m_renderer;
     AssetManager* m_assetManager;
     ResourceManager* m_resourceManager;
+    JobSystem* m_jobSystem;
     
     // RmlUI objects
     std::unique_ptr<VulkanRmlRenderer> m_rmlRenderer;
     std::unique_ptr<SystemInterface> m_systemInterface;
     std::unique_ptr<FileInterface> m_fileInterface;
     Rml::Context* m_context = nullptr;
+    std::vector<Rml::Context*> m_layers;    // Bottom to top, m_context first
     
     // Document management
     std::unordered_map<std::string, Rml::ElementDocument*> m_loadedDocuments;
@@ -0,0 +1,197 @@
+#include "UIDamageTracker.h"
+#include <algorithm>
+
+namespace {
+    int64_t Area(const VkRect2D& rect) {
+        return static_cast<int64_t>(rect.extent.width) * rect.extent.height;
+    }
+
+    bool Overlaps(const VkRect2D& a, const VkRect2D& b) {
+        return a.offset.x < b.offset.x + static_cast<int32_t>(b.extent.width) &&
+               b.offset.x < a.offset.x + static_cast<int32_t>(a.extent.width) &&
+               a.offset.y < b.offset.y + static_cast<int32_t>(b.extent.height) &&
+               b.offset.y < a.offset.y + static_cast<int32_t>(a.extent.height);
+    }
+
+    VkRect2D Union(const VkRect2D& a, const VkRect2D& b) {
+        int32_t left = std::min(a.offset.x, b.offset.x);
+        int32_t top = std::min(a.offset.y, b.offset.y);
+        int32_t right = std::max(a.offset.x + static_cast<int32_t>(a.extent.width),
+                                 b.offset.x + static_cast<int32_t>(b.extent.width));
+        int32_t bottom = std::max(a.offset.y + static_cast<int32_t>(a.extent.height),
+                                  b.offset.y + static_cast<int32_t>(b.extent.height));
+
+        VkRect2D result = {};
+        result.offset = {left, top};
+        result.extent = {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)};
+        return result;
+    }
+}
+
+void UIDamageTracker::BeginFrame(uint32_t width, uint32_t height) {
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        m_invalidated = true;
+    }
+
+    m_current.clear();
+}
+
+void UIDamageTracker::Record(uint64_t key, const VkRect2D& bounds) {
+    // Draws that cover no pixels cannot change any, wherever they sit in paint order
+    if (bounds.extent.width == 0 || bounds.extent.height == 0) {
+        return;
+    }
+
+    m_current.push_back({key, bounds});
+}
+
+const std::vector<VkRect2D>& UIDamageTracker::EndFrame() {
+    m_damage.clear();
+    m_fullRedraw = false;
+
+    if (m_invalidated) {
+        SetFullDamage();
+    } else {
+        DiffFrames();
+
+        int64_t damagedArea = 0;
+        for (const VkRect2D& rect : m_damage) {
+            damagedArea += Area(rect);
+        }
+        if (damagedArea >= static_cast<int64_t>(FULL_REDRAW_COVERAGE * m_width * m_height)) {
+            SetFullDamage();
+        }
+    }
+
+    m_invalidated = false;
+    std::swap(m_previous, m_current);
+    m_current.clear();
+    return m_damage;
+}
+
+void UIDamageTracker::DiffFrames() {
+    // Most frames change a few draws in the middle of the list, or none at all
+    const size_t previousCount = m_previous.size();
+    const size_t currentCount = m_current.size();
+    const size_t commonCount = std::min(previousCount, currentCount);
+
+    size_t prefix = 0;
+    while (prefix < commonCount && m_previous[prefix].key == m_current[prefix].key) {
+        ++prefix;
+    }
+
+    size_t suffix = 0;
+    while (suffix < commonCount - prefix &&
+           m_previous[previousCount - 1 - suffix].key == m_current[currentCount - 1 - suffix].key) {
+        ++suffix;
+    }
+
+    const size_t previousEnd = previousCount - suffix;
+    const size_t currentEnd = currentCount - suffix;
+    if (prefix == previousEnd && prefix == currentEnd) {
+        return;
+    }
+
+    // Index the previous middle by key; each list holds indices in reverse so back() is the earliest
+    for (auto& entry : m_previousByKey) {
+        entry.second.clear();
+    }
+    for (size_t i = previousEnd; i > prefix; --i) {
+        m_previousByKey[m_previous[i - 1].key].push_back(static_cast<uint32_t>(i - 1));
+    }
+    m_previousMatched.assign(previousEnd - prefix, false);
+
+    // A pixel only changes if a draw covering it appeared, disappeared, or swapped order with
+    // another one covering it. Of every swapped pair, the later-painted draw lands below the
+    // running maximum of matched indices, so damaging those catches every reordering.
+    bool anyMatched = false;
+    uint32_t highestMatched = 0;
+    for (size_t j = prefix; j < currentEnd; ++j) {
+        const DrawRecord& draw = m_current[j];
+        auto it = m_previousByKey.find(draw.key);
+        if (it == m_previousByKey.end() || it->second.empty()) {
+            AddDamage(draw.bounds);
+            continue;
+        }
+
+        uint32_t previousIndex = it->second.back();
+        it->second.pop_back();
+        m_previousMatched[previousIndex - prefix] = true;
+
+        if (anyMatched && previousIndex < highestMatched) {
+            AddDamage(draw.bounds);
+        } else {
+            highestMatched = previousIndex;
+            anyMatched = true;
+        }
+    }
+
+    for (size_t i = prefix; i < previousEnd; ++i) {
+        if (!m_previousMatched[i - prefix]) {
+            AddDamage(m_previous[i].bounds);
+        }
+    }
+
+    // Keys are mostly unique per frame; drop them so the index does not grow without bound
+    if (m_previousByKey.size() > 4 * (previousEnd - prefix) + 64) {
+        m_previousByKey.clear();
+    }
+}
+
+void UIDamageTracker::AddDamage(VkRect2D rect) {
+    // Clip to the target
+    int32_t left = std::max(rect.offset.x, 0);
+    int32_t top = std::max(rect.offset.y, 0);
+    int32_t right = std::min(rect.offset.x + static_cast<int32_t>(rect.extent.width), static_cast<int32_t>(m_width));
+    int32_t bottom = std::min(rect.offset.y + static_cast<int32_t>(rect.extent.height), static_cast<int32_t>(m_height));
+    if (right <= left || bottom <= top) {
+        return;
+    }
+    rect.offset = {left, top};
+    rect.extent = {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)};
+
+    // Rectangles stay disjoint, so redrawing each one clipped never blends a pixel twice
+    while (true) {
+        auto overlapping = std::find_if(m_damage.begin(), m_damage.end(),
+                                        [&rect](const VkRect2D& existing) { return Overlaps(existing, rect); });
+        if (overlapping != m_damage.end()) {
+            rect = Union(rect, *overlapping);
+            *overlapping = m_damage.back();
+            m_damage.pop_back();
+            continue;
+        }
+
+        if (m_damage.size() < MAX_DAMAGE_RECTS) {
+            m_damage.push_back(rect);
+            return;
+        }
+
+        // Out of rectangles: fold into the one whose bounding box grows the least
+        size_t best = 0;
+        int64_t bestGrowth = INT64_MAX;
+        for (size_t i = 0; i < m_damage.size(); ++i) {
+            int64_t growth = Area(Union(m_damage[i], rect)) - Area(m_damage[i]) - Area(rect);
+            if (growth < bestGrowth) {
+                bestGrowth = growth;
+                best = i;
+            }
+        }
+        rect = Union(rect, m_damage[best]);
+        m_damage[best] = m_damage.back();
+        m_damage.pop_back();
+    }
+}
+
+void UIDamageTracker::SetFullDamage() {
+    m_damage.clear();
+    if (m_width == 0 || m_height == 0) {
+        return;
+    }
+
+    VkRect2D full = {};
+    full.extent = {m_width, m_height};
+    m_damage.push_back(full);
+    m_fullRedraw = true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * UIDamageTracker works out which parts of the UI changed since the previous frame.
+ * This class handles:
+ * - Collecting one key and screen rectangle per draw as the frame is recorded
+ * - Diffing the draw list against the previous frame: draws that appeared, disappeared
+ *   or changed their paint order damage their rectangles
+ * - Merging the damage into a few disjoint rectangles, or a full redraw when that is cheaper
+ *
+ * A draw's key must cover everything that affects its pixels (geometry, texture, transform,
+ * translation, scissor), so two draws with the same key paint the same pixels. Anything that
+ * changes pixels without changing keys, such as a resized target, must call InvalidateAll.
+ */
+class UIDamageTracker {
+public:
+    void BeginFrame(uint32_t width, uint32_t height);
+    void Record(uint64_t key, const VkRect2D& bounds);
+
+    // The next EndFrame reports the whole target
+    void InvalidateAll() { m_invalidated = true; }
+
+    // Disjoint rectangles that must be redrawn; empty when the frame matches the previous one
+    const std::vector<VkRect2D>& EndFrame();
+    const std::vector<VkRect2D>& GetDamage() const { return m_damage; }
+    bool IsFullRedraw() const { return m_fullRedraw; }
+
+    // More rectangles than this are merged; clipping each one re-issues the draws it touches
+    static constexpr size_t MAX_DAMAGE_RECTS = 8;
+    // Past this share of the target a full redraw is cheaper than clipping
+    static constexpr float FULL_REDRAW_COVERAGE = 0.6f;
+
+private:
+    struct DrawRecord {
+        uint64_t key;
+        VkRect2D bounds;
+    };
+
+    void DiffFrames();
+    void AddDamage(VkRect2D rect);
+    void SetFullDamage();
+
+    std::vector<DrawRecord> m_previous;
+    std::vector<DrawRecord> m_current;
+    std::vector<VkRect2D> m_damage;
+
+    // Scratch for DiffFrames: unmatched previous draws by key, in paint order
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_previousByKey;
+    std::vector<bool> m_previousMatched;
+
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    bool m_invalidated = true;
+    bool m_fullRedraw = false;
+};
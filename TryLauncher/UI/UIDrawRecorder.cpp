@@ -0,0 +1,192 @@
+#include "UIDrawRecorder.h"
+#include <algorithm>
+
+namespace {
+    bool SameRect(const VkRect2D& a, const VkRect2D& b) {
+        return a.offset.x == b.offset.x && a.offset.y == b.offset.y &&
+               a.extent.width == b.extent.width && a.extent.height == b.extent.height;
+    }
+
+    VkRect2D UnionRect(const VkRect2D& a, const VkRect2D& b) {
+        if (a.extent.width == 0 || a.extent.height == 0) {
+            return b;
+        }
+        if (b.extent.width == 0 || b.extent.height == 0) {
+            return a;
+        }
+
+        int32_t left = std::min(a.offset.x, b.offset.x);
+        int32_t top = std::min(a.offset.y, b.offset.y);
+        int32_t right = std::max(a.offset.x + static_cast<int32_t>(a.extent.width),
+                                 b.offset.x + static_cast<int32_t>(b.extent.width));
+        int32_t bottom = std::max(a.offset.y + static_cast<int32_t>(a.extent.height),
+                                  b.offset.y + static_cast<int32_t>(b.extent.height));
+
+        VkRect2D result = {};
+        result.offset = {left, top};
+        result.extent = {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)};
+        return result;
+    }
+}
+
+UIDrawRecorder::UIDrawRecorder(UIGeometryHeap* geometryHeap)
+    : m_geometryHeap(geometryHeap) {
+}
+
+void UIDrawRecorder::Reset(uint32_t framebufferWidth, uint32_t framebufferHeight, const glm::mat4& transform) {
+    m_draws.clear();
+    m_batches.clear();
+    m_transforms.clear();
+    m_transforms.push_back(transform);
+
+    m_fullScissor.offset = {0, 0};
+    m_fullScissor.extent = {framebufferWidth, framebufferHeight};
+    m_scissor = m_fullScissor;
+    m_layer = 0;
+
+    m_recordedDraws = 0;
+    m_builtBatches = 0;
+}
+
+void UIDrawRecorder::SetTransform(const glm::mat4& transform) {
+    // RmlUi re-sends the same transform often; only a real change splits batches
+    if (m_transforms.empty() || m_transforms.back() != transform) {
+        m_transforms.push_back(transform);
+    }
+}
+
+void UIDrawRecorder::SetScissor(bool enabled, const VkRect2D& rect) {
+    m_scissor = enabled ? rect : m_fullScissor;
+}
+
+void UIDrawRecorder::Record(const GeometryAllocation& allocation,
+                            VkDeviceSize indexOffset,
+                            uint32_t indexCount,
+                            const Rml::Vertex* vertices,
+                            uint32_t vertexCount,
+                            const int* indices,
+                            glm::vec2 translation,
+                            Rml::TextureHandle texture,
+                            uintptr_t textureGroup,
+                            const glm::vec4& uvRect,
+                            const VkRect2D& bounds) {
+    if (!allocation.IsValid() || indexCount == 0 || m_transforms.empty()) {
+        return;
+    }
+
+    DrawCommand draw = {};
+    draw.batch.buffer = allocation.buffer;
+    draw.batch.vertexOffset = allocation.offset;
+    draw.batch.indexOffset = allocation.offset + indexOffset;
+    draw.batch.indexCount = indexCount;
+    draw.batch.texture = texture;
+    draw.batch.textureGroup = textureGroup;
+    draw.batch.uvRect = uvRect;
+    draw.batch.scissor = m_scissor;
+    draw.batch.bounds = bounds;
+    draw.batch.transform = static_cast<uint32_t>(m_transforms.size() - 1);
+    draw.batch.translation = translation;
+    draw.batch.layer = m_layer;
+
+    bool mergeable = vertices && indices && vertexCount <= MAX_MERGE_VERTICES;
+    draw.vertices = mergeable ? vertices : nullptr;
+    draw.indices = mergeable ? indices : nullptr;
+    draw.vertexCount = vertexCount;
+
+    m_draws.push_back(draw);
+    ++m_recordedDraws;
+}
+
+bool UIDrawRecorder::CanMerge(const DrawCommand& first, const DrawCommand& next, uint32_t batchVertices) const {
+    return next.vertices &&
+           next.batch.textureGroup == first.batch.textureGroup &&
+           next.batch.transform == first.batch.transform &&
+           next.batch.layer == first.batch.layer &&
+           SameRect(next.batch.scissor, first.batch.scissor) &&
+           batchVertices + next.vertexCount <= MAX_BATCH_VERTICES;
+}
+
+const std::vector<UIDrawBatch>& UIDrawRecorder::Build() {
+    m_batches.clear();
+
+    size_t i = 0;
+    while (i < m_draws.size()) {
+        const DrawCommand& first = m_draws[i];
+        uint32_t vertexCount = first.vertexCount;
+        uint32_t indexCount = first.batch.indexCount;
+
+        size_t end = i + 1;
+        if (first.vertices) {
+            while (end < m_draws.size() && CanMerge(first, m_draws[end], vertexCount)) {
+                vertexCount += m_draws[end].vertexCount;
+                indexCount += m_draws[end].batch.indexCount;
+                ++end;
+            }
+        }
+
+        if (end - i > 1 && WriteMergedBatch(i, end, vertexCount, indexCount)) {
+            i = end;
+            continue;
+        }
+
+        // Single draw, or the merge did not fit: draw straight from its own allocations
+        for (; i < end; ++i) {
+            m_batches.push_back(m_draws[i].batch);
+        }
+    }
+
+    m_builtBatches += static_cast<uint32_t>(m_batches.size());
+    m_draws.clear();
+    return m_batches;
+}
+
+bool UIDrawRecorder::WriteMergedBatch(size_t first, size_t last, uint32_t vertexCount, uint32_t indexCount) {
+    VkDeviceSize vertexDataSize = sizeof(Rml::Vertex) * vertexCount;
+    VkDeviceSize indexDataSize = sizeof(uint32_t) * indexCount;
+
+    GeometryAllocation allocation;
+    if (!m_geometryHeap->Allocate(vertexDataSize + indexDataSize, allocation)) {
+        return false;
+    }
+
+    Rml::Vertex* vertices = reinterpret_cast<Rml::Vertex*>(allocation.data);
+    uint32_t* indices = reinterpret_cast<uint32_t*>(allocation.data + vertexDataSize);
+    uint32_t baseVertex = 0;
+    VkRect2D bounds = {};
+
+    for (size_t i = first; i < last; ++i) {
+        const DrawCommand& draw = m_draws[i];
+        bounds = UnionRect(bounds, draw.batch.bounds);
+        const Rml::Vector2f translation(draw.batch.translation.x, draw.batch.translation.y);
+        const glm::vec4& uv = draw.batch.uvRect;
+
+        // Translation and atlas UVs are baked into the vertices, so the merged draw pushes neither
+        for (uint32_t v = 0; v < draw.vertexCount; ++v) {
+            Rml::Vertex vertex = draw.vertices[v];
+            vertex.position += translation;
+            vertex.tex_coord = Rml::Vector2f(uv.x + vertex.tex_coord.x * uv.z, uv.y + vertex.tex_coord.y * uv.w);
+            vertices[baseVertex + v] = vertex;
+        }
+        for (uint32_t n = 0; n < draw.batch.indexCount; ++n) {
+            *indices++ = baseVertex + static_cast<uint32_t>(draw.indices[n]);
+        }
+
+        baseVertex += draw.vertexCount;
+    }
+
+    m_geometryHeap->Flush(allocation);
+
+    UIDrawBatch batch = m_draws[first].batch;
+    batch.buffer = allocation.buffer;
+    batch.vertexOffset = allocation.offset;
+    batch.indexOffset = allocation.offset + vertexDataSize;
+    batch.indexCount = indexCount;
+    batch.translation = glm::vec2(0.0f);
+    batch.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    batch.bounds = bounds;
+    m_batches.push_back(batch);
+
+    // Only needed for this frame; the heap holds the space until the GPU is done with it
+    m_geometryHeap->Free(allocation);
+    return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <RmlUi/Core/Types.h>
+#include <RmlUi/Core/Vertex.h>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "UIGeometryHeap.h"
+
+// One resolved draw: a single vkCmdDrawIndexed plus the state it needs
+struct UIDrawBatch {
+    VkBuffer buffer = VK_NULL_HANDLE;   // Holds both vertices and indices
+    VkDeviceSize vertexOffset = 0;      // Absolute offsets into buffer
+    VkDeviceSize indexOffset = 0;
+    uint32_t indexCount = 0;
+    Rml::TextureHandle texture = 0;
+    uintptr_t textureGroup = 0;         // Draws in the same group can share a batch, e.g. one atlas page
+    glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);  // Offset in xy, scale in zw
+    VkRect2D scissor = {};
+    VkRect2D bounds = {};               // Pixels the draw can touch, already clipped to scissor
+    uint32_t transform = 0;             // Index for UIDrawRecorder::GetTransform
+    glm::vec2 translation = glm::vec2(0.0f);
+    uint32_t layer = 0;                 // Batches of one layer are contiguous, in layer order
+};
+
+/**
+ * UIDrawRecorder buffers a frame's RmlUi draws and turns them into as few draw calls as possible.
+ * This class handles:
+ * - Tracking transform and scissor state as RmlUi changes it
+ * - Merging consecutive draws that share texture group, scissor and transform into one draw
+ * - Writing merged geometry, with translation and atlas UVs applied, into the UIGeometryHeap
+ *
+ * Draws are never reordered, so blending order is kept, and never merged across layers, so
+ * each layer can be replayed on its own. Only geometry recorded with CPU-side
+ * vertices and indices can be merged; the rest is drawn from its own allocation. Those arrays
+ * must stay alive until Build(). Merged geometry is freed back to the heap right away, which
+ * keeps it untouched until frames in flight are done with it.
+ */
+class UIDrawRecorder {
+public:
+    explicit UIDrawRecorder(UIGeometryHeap* geometryHeap);
+
+    // Start of frame; scissor disabled means the whole framebuffer
+    void Reset(uint32_t framebufferWidth, uint32_t framebufferHeight, const glm::mat4& transform);
+
+    void SetTransform(const glm::mat4& transform);
+    void SetScissor(bool enabled, const VkRect2D& rect);
+    // Draws recorded after this belong to the next layer
+    void BeginLayer() { ++m_layer; }
+
+    // vertices and indices may be null for geometry that should not be merged;
+    // bounds is the draw's screen rectangle, used to skip it outside redrawn regions
+    void Record(const GeometryAllocation& allocation,
+                VkDeviceSize indexOffset,
+                uint32_t indexCount,
+                const Rml::Vertex* vertices,
+                uint32_t vertexCount,
+                const int* indices,
+                glm::vec2 translation,
+                Rml::TextureHandle texture,
+                uintptr_t textureGroup,
+                const glm::vec4& uvRect,
+                const VkRect2D& bounds);
+
+    bool HasPendingDraws() const { return !m_draws.empty(); }
+    // Drops the recorded draws without building them, e.g. when nothing needs redrawing
+    void Discard() { m_draws.clear(); }
+
+    // Resolves the recorded draws and clears them; valid until the next Build() or Reset()
+    const std::vector<UIDrawBatch>& Build();
+    const glm::mat4& GetTransform(uint32_t index) const { return m_transforms[index]; }
+
+    // Statistics for the current frame
+    uint32_t GetRecordedDrawCount() const { return m_recordedDraws; }
+    uint32_t GetBatchCount() const { return m_builtBatches; }
+
+    // Geometry larger than this is cheaper to draw on its own than to copy
+    static constexpr uint32_t MAX_MERGE_VERTICES = 256;
+    static constexpr uint32_t MAX_BATCH_VERTICES = 16384;
+
+private:
+    struct DrawCommand {
+        UIDrawBatch batch;
+        const Rml::Vertex* vertices;
+        const int* indices;
+        uint32_t vertexCount;
+    };
+
+    bool CanMerge(const DrawCommand& first, const DrawCommand& next, uint32_t batchVertices) const;
+    bool WriteMergedBatch(size_t first, size_t last, uint32_t vertexCount, uint32_t indexCount);
+
+    UIGeometryHeap* m_geometryHeap;
+
+    std::vector<DrawCommand> m_draws;
+    std::vector<UIDrawBatch> m_batches;
+    std::vector<glm::mat4> m_transforms;
+
+    VkRect2D m_fullScissor = {};
+    VkRect2D m_scissor = {};
+    uint32_t m_layer = 0;
+
+    uint32_t m_recordedDraws = 0;
+    uint32_t m_builtBatches = 0;
+};
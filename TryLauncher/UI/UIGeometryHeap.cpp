@@ -0,0 +1,310 @@
+#include "UIGeometryHeap.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    constexpr VkBufferUsageFlags GEOMETRY_USAGE = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+}
+
+UIGeometryHeap::UIGeometryHeap(ResourceManager* resourceManager)
+    : m_resourceManager(resourceManager) {
+}
+
+UIGeometryHeap::~UIGeometryHeap() {
+    if (m_initialized) {
+        Shutdown();
+    }
+}
+
+bool UIGeometryHeap::Initialize(VkDeviceSize ringSize, VkDeviceSize blockSize) {
+    if (m_initialized) {
+        return true;
+    }
+
+    if (!m_resourceManager) {
+        std::cerr << "UIGeometryHeap: ResourceManager is required" << std::endl;
+        return false;
+    }
+
+    m_ringBuffer = m_resourceManager->CreateBuffer(ringSize, GEOMETRY_USAGE,
+                                                   VMA_MEMORY_USAGE_CPU_TO_GPU,
+                                                   VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    m_ringData = static_cast<unsigned char*>(m_ringBuffer.GetMappedData());
+    if (!m_ringData) {
+        std::cerr << "UIGeometryHeap: Failed to create geometry ring" << std::endl;
+        if (m_ringBuffer.IsValid()) {
+            m_resourceManager->DestroyBuffer(m_ringBuffer);
+            m_ringBuffer = {};
+        }
+        return false;
+    }
+
+    m_ringSize = ringSize;
+    m_ringHead = 0;
+    m_ringTail = 0;
+    m_ringUsed = 0;
+    m_ringFrameConsumed = 0;
+    m_blockSize = blockSize;
+    m_frame = 0;
+
+    m_initialized = true;
+    return true;
+}
+
+void UIGeometryHeap::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    for (auto& live : m_liveRingAllocations) {
+        live.clear();
+    }
+    m_ringFrames.clear();
+    m_pendingFrees.clear();
+
+    for (auto& block : m_blocks) {
+        m_resourceManager->DestroyBuffer(block->buffer);
+    }
+    m_blocks.clear();
+
+    // Persistently mapped through VMA; destroying the buffer releases the mapping
+    m_resourceManager->DestroyBuffer(m_ringBuffer);
+    m_ringBuffer = {};
+    m_ringData = nullptr;
+
+    m_initialized = false;
+}
+
+bool UIGeometryHeap::Allocate(VkDeviceSize size, GeometryAllocation& allocation) {
+    allocation = GeometryAllocation{};
+    if (!m_initialized || size == 0) {
+        return false;
+    }
+
+    // A full ring only means a burst of new geometry; it goes straight to the blocks
+    return AllocateRing(size, allocation) || AllocateBlock(size, allocation);
+}
+
+bool UIGeometryHeap::AllocateRing(VkDeviceSize size, GeometryAllocation& allocation) {
+    if (size > m_ringSize) {
+        return false;
+    }
+
+    if (m_ringUsed == 0) {
+        m_ringHead = 0;
+        m_ringTail = 0;
+    } else if (m_ringHead == m_ringTail) {
+        return false; // Full
+    }
+
+    VkDeviceSize start = AlignUp(m_ringHead, ALIGNMENT);
+    VkDeviceSize consumed = 0;
+
+    if (m_ringHead >= m_ringTail) {
+        // Free space is [head, size) followed by [0, tail)
+        if (start + size <= m_ringSize) {
+            consumed = start + size - m_ringHead;
+        } else if (size <= m_ringTail) {
+            consumed = (m_ringSize - m_ringHead) + size;
+            start = 0;
+        } else {
+            return false;
+        }
+    } else {
+        // Free space is [head, tail)
+        if (start + size > m_ringTail) {
+            return false;
+        }
+        consumed = start + size - m_ringHead;
+    }
+
+    m_ringHead = start + size;
+    m_ringUsed += consumed;
+    m_ringFrameConsumed += consumed;
+
+    allocation.buffer = m_ringBuffer.buffer;
+    allocation.offset = start;
+    allocation.size = size;
+    allocation.data = m_ringData + start;
+    allocation.block = RING_BLOCK;
+    allocation.frame = m_frame;
+
+    auto& live = m_liveRingAllocations[m_frame % m_liveRingAllocations.size()];
+    allocation.liveIndex = live.size();
+    live.push_back(&allocation);
+    return true;
+}
+
+bool UIGeometryHeap::AllocateBlock(VkDeviceSize size, GeometryAllocation& allocation) {
+    VkDeviceSize alignedSize = AlignUp(size, ALIGNMENT);
+
+    for (uint32_t attempt = 0; attempt < 2; ++attempt) {
+        // First fit, oldest blocks first so newer ones can drain
+        for (uint32_t i = 0; i < m_blocks.size(); ++i) {
+            Block& block = *m_blocks[i];
+            for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+                if (it->second < alignedSize) {
+                    continue;
+                }
+
+                VkDeviceSize offset = it->first;
+                VkDeviceSize remaining = it->second - alignedSize;
+                block.freeRanges.erase(it);
+                if (remaining > 0) {
+                    block.freeRanges[offset + alignedSize] = remaining;
+                }
+
+                allocation.buffer = block.buffer.buffer;
+                allocation.offset = offset;
+                allocation.size = size;
+                allocation.data = block.data + offset;
+                allocation.block = i;
+                return true;
+            }
+        }
+
+        if (attempt == 0 && !CreateBlock(alignedSize)) {
+            break;
+        }
+    }
+
+    std::cerr << "UIGeometryHeap: Out of geometry memory (" << size << " bytes requested)" << std::endl;
+    return false;
+}
+
+bool UIGeometryHeap::CreateBlock(VkDeviceSize minimumSize) {
+    auto block = std::make_unique<Block>();
+    block->size = std::max(m_blockSize, minimumSize);
+    block->buffer = m_resourceManager->CreateBuffer(block->size, GEOMETRY_USAGE,
+                                                    VMA_MEMORY_USAGE_CPU_TO_GPU,
+                                                    VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    block->data = static_cast<unsigned char*>(block->buffer.GetMappedData());
+    if (!block->data) {
+        if (block->buffer.IsValid()) {
+            m_resourceManager->DestroyBuffer(block->buffer);
+        }
+        return false;
+    }
+
+    block->freeRanges[0] = block->size;
+    m_blocks.push_back(std::move(block));
+    return true;
+}
+
+void UIGeometryHeap::Flush(const GeometryAllocation& allocation) {
+    if (!allocation.IsValid()) {
+        return;
+    }
+
+    const AllocatedBuffer& buffer = allocation.block == RING_BLOCK ? m_ringBuffer : m_blocks[allocation.block]->buffer;
+    m_resourceManager->FlushBuffer(buffer, allocation.offset, allocation.size);
+}
+
+void UIGeometryHeap::Free(GeometryAllocation& allocation) {
+    if (!m_initialized || !allocation.IsValid()) {
+        return;
+    }
+
+    if (allocation.block == RING_BLOCK) {
+        // Ring space comes back with its frame
+        Untrack(allocation);
+    } else {
+        // Frames still in flight may draw from it
+        m_pendingFrees.push_back({allocation.block, allocation.offset, AlignUp(allocation.size, ALIGNMENT), m_frame});
+    }
+
+    allocation = GeometryAllocation{};
+}
+
+void UIGeometryHeap::Untrack(GeometryAllocation& allocation) {
+    auto& live = m_liveRingAllocations[allocation.frame % m_liveRingAllocations.size()];
+    size_t index = allocation.liveIndex;
+    if (index >= live.size() || live[index] != &allocation) {
+        return;
+    }
+
+    live[index] = live.back();
+    live[index]->liveIndex = index;
+    live.pop_back();
+}
+
+void UIGeometryHeap::ReleaseRange(uint32_t block, VkDeviceSize offset, VkDeviceSize size) {
+    auto& ranges = m_blocks[block]->freeRanges;
+
+    auto next = ranges.lower_bound(offset);
+    if (next != ranges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            ranges.erase(previous);
+        }
+    }
+    if (next != ranges.end() && offset + size == next->first) {
+        size += next->second;
+        ranges.erase(next);
+    }
+
+    ranges[offset] = size;
+}
+
+void UIGeometryHeap::Promote(GeometryAllocation& allocation) {
+    GeometryAllocation promoted;
+    if (!AllocateBlock(allocation.size, promoted)) {
+        // Its ring space is about to be reused; drop it rather than draw garbage
+        std::cerr << "UIGeometryHeap: Failed to move geometry out of the frame ring" << std::endl;
+        allocation = GeometryAllocation{};
+        return;
+    }
+
+    std::memcpy(promoted.data, allocation.data, static_cast<size_t>(allocation.size));
+    Flush(promoted);
+    allocation = promoted;
+}
+
+void UIGeometryHeap::BeginFrame() {
+    if (!m_initialized) {
+        return;
+    }
+
+    // Close the ring region of the frame that just ended
+    m_ringFrames.push_back({m_frame, m_ringHead, m_ringFrameConsumed});
+    m_ringFrameConsumed = 0;
+    ++m_frame;
+
+    // Geometry that survived long enough is long-lived; move it to the blocks. The old
+    // copy may still be read by frames in flight, which the reclaim below accounts for.
+    if (m_frame >= PROMOTE_AFTER_FRAMES) {
+        auto& live = m_liveRingAllocations[(m_frame - PROMOTE_AFTER_FRAMES) % m_liveRingAllocations.size()];
+        std::vector<GeometryAllocation*> survivors;
+        survivors.swap(live);
+        for (GeometryAllocation* allocation : survivors) {
+            Promote(*allocation);
+        }
+    }
+
+    // A ring frame was last read by the frame before its geometry was promoted, and
+    // that frame has completed once FRAMES_IN_FLIGHT further frames have begun
+    while (!m_ringFrames.empty() &&
+           m_ringFrames.front().frame + PROMOTE_AFTER_FRAMES + FRAMES_IN_FLIGHT <= m_frame + 1) {
+        const RingFrame& ringFrame = m_ringFrames.front();
+        // A frame that allocated nothing may predate a reset of the empty ring
+        if (ringFrame.consumed > 0) {
+            m_ringTail = ringFrame.end;
+            m_ringUsed -= ringFrame.consumed;
+        }
+        m_ringFrames.pop_front();
+    }
+
+    while (!m_pendingFrees.empty() && m_pendingFrees.front().frame + FRAMES_IN_FLIGHT <= m_frame) {
+        const PendingFree& pending = m_pendingFrees.front();
+        ReleaseRange(pending.block, pending.offset, pending.size);
+        m_pendingFrees.pop_front();
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../Vulkan/ResourceManager.h"
+#include "../Vulkan/VulkanSwapchain.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Where one piece of compiled UI geometry lives inside the UIGeometryHeap
+struct GeometryAllocation {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    unsigned char* data = nullptr;  // Persistently mapped, at offset
+
+    bool IsValid() const { return buffer != VK_NULL_HANDLE; }
+
+private:
+    friend class UIGeometryHeap;
+    uint32_t block = 0;     // Heap block, or RING_BLOCK
+    uint64_t frame = 0;     // Frame a ring allocation was made in
+    size_t liveIndex = 0;   // Position in that frame's live list
+};
+
+/**
+ * UIGeometryHeap suballocates UI vertex and index data from a few large buffers.
+ * This class handles:
+ * - A frame ring for new geometry, reclaimed wholesale once the GPU has finished with it
+ * - Free-list blocks for geometry that outlives the ring, with coalescing
+ * - Deferring frees until frames in flight can no longer read the memory
+ *
+ * New geometry goes to the ring. Geometry still alive PROMOTE_AFTER_FRAMES frames later is
+ * copied into a block and its GeometryAllocation updated in place, so the allocation object
+ * must keep its address until Free(). Everything is host visible and persistently mapped;
+ * vertex and index data of one geometry share an allocation.
+ *
+ * BeginFrame() must be called once per frame after the frame slot's timeline wait.
+ * Not thread safe; the UI renderer uses it from one thread.
+ */
+class UIGeometryHeap {
+public:
+    explicit UIGeometryHeap(ResourceManager* resourceManager);
+    ~UIGeometryHeap();
+
+    bool Initialize(VkDeviceSize ringSize = DEFAULT_RING_SIZE, VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+    // The GPU must be idle
+    void Shutdown();
+
+    // Space for new geometry; write through allocation.data, then Flush()
+    bool Allocate(VkDeviceSize size, GeometryAllocation& allocation);
+    void Flush(const GeometryAllocation& allocation);
+    void Free(GeometryAllocation& allocation);
+
+    void BeginFrame();
+
+    // Statistics
+    size_t GetBlockCount() const { return m_blocks.size(); }
+    VkDeviceSize GetRingBytesInUse() const { return m_ringUsed; }
+
+    static constexpr VkDeviceSize DEFAULT_RING_SIZE = 4 * 1024 * 1024;
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+    static constexpr VkDeviceSize ALIGNMENT = 16;
+    static constexpr uint32_t PROMOTE_AFTER_FRAMES = 2;
+
+private:
+    static constexpr uint32_t RING_BLOCK = UINT32_MAX;
+    static constexpr uint32_t FRAMES_IN_FLIGHT = VulkanSwapchain::MAX_FRAMES_IN_FLIGHT;
+
+    struct Block {
+        AllocatedBuffer buffer;
+        unsigned char* data = nullptr;
+        VkDeviceSize size = 0;
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges; // Offset -> size
+    };
+
+    struct PendingFree {
+        uint32_t block;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        uint64_t frame;
+    };
+
+    // Ring space used by one frame, released as a whole
+    struct RingFrame {
+        uint64_t frame;
+        VkDeviceSize end;
+        VkDeviceSize consumed;
+    };
+
+    bool AllocateRing(VkDeviceSize size, GeometryAllocation& allocation);
+    bool AllocateBlock(VkDeviceSize size, GeometryAllocation& allocation);
+    bool CreateBlock(VkDeviceSize minimumSize);
+    void ReleaseRange(uint32_t block, VkDeviceSize offset, VkDeviceSize size);
+    void Untrack(GeometryAllocation& allocation);
+    void Promote(GeometryAllocation& allocation);
+
+    ResourceManager* m_resourceManager;
+    VkDeviceSize m_blockSize = DEFAULT_BLOCK_SIZE;
+
+    // Frame ring
+    AllocatedBuffer m_ringBuffer;
+    unsigned char* m_ringData = nullptr;
+    VkDeviceSize m_ringSize = 0;
+    VkDeviceSize m_ringHead = 0;
+    VkDeviceSize m_ringTail = 0;
+    VkDeviceSize m_ringUsed = 0;
+    VkDeviceSize m_ringFrameConsumed = 0;
+    std::deque<RingFrame> m_ringFrames;
+
+    // Live ring allocations per frame, indexed by frame % size; promoted when they age out
+    std::array<std::vector<GeometryAllocation*>, PROMOTE_AFTER_FRAMES + 1> m_liveRingAllocations;
+
+    std::vector<std::unique_ptr<Block>> m_blocks;
+    std::deque<PendingFree> m_pendingFrees;
+
+    uint64_t m_frame = 0;
+    bool m_initialized = false;
+};
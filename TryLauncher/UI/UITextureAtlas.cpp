@@ -0,0 +1,148 @@
+#include "UITextureAtlas.h"
+#include <algorithm>
+
+UITextureAtlas::UITextureAtlas(uint32_t width, uint32_t height, uint32_t padding)
+    : m_width(width), m_height(height), m_padding(padding) {
+}
+
+bool UITextureAtlas::Allocate(uint32_t width, uint32_t height, AtlasRect& rect) {
+    uint32_t paddedWidth = width + 2 * m_padding;
+    uint32_t paddedHeight = height + 2 * m_padding;
+    if (width == 0 || height == 0 || paddedWidth > m_width || paddedHeight > m_height) {
+        return false;
+    }
+
+    uint32_t shelfHeight = std::min(m_height, (paddedHeight + SHELF_HEIGHT_STEP - 1) / SHELF_HEIGHT_STEP * SHELF_HEIGHT_STEP);
+
+    // Best fit among shelves that waste little height; empty shelves can be cut to size
+    uint32_t best = UINT32_MAX;
+    uint32_t bestWaste = UINT32_MAX;
+    for (uint32_t i = 0; i < m_shelves.size(); ++i) {
+        const Shelf& shelf = m_shelves[i];
+        if (shelf.height < paddedHeight) {
+            continue;
+        }
+
+        bool empty = shelf.usedWidth == 0;
+        uint32_t waste = empty ? shelfHeight - paddedHeight + 1 : shelf.height - paddedHeight;
+        if (!empty && shelf.height > shelfHeight + shelfHeight / 2) {
+            continue;
+        }
+
+        bool fits = std::any_of(shelf.freeSpans.begin(), shelf.freeSpans.end(),
+                                [paddedWidth](const Span& span) { return span.width >= paddedWidth; });
+        if (fits && waste < bestWaste) {
+            best = i;
+            bestWaste = waste;
+        }
+    }
+
+    if (best != UINT32_MAX) {
+        Shelf& shelf = m_shelves[best];
+        if (shelf.usedWidth == 0 && shelf.height > shelfHeight) {
+            // Keep what this image needs and hand the rest back as another empty shelf
+            uint32_t remainder = shelf.height - shelfHeight;
+            shelf.height = shelfHeight;
+            InsertShelf(shelf.y + shelfHeight, remainder);
+        }
+        return AllocateFromShelf(best, paddedWidth, paddedHeight, rect);
+    }
+
+    if (m_shelfEnd + shelfHeight <= m_height) {
+        InsertShelf(m_shelfEnd, shelfHeight);
+        m_shelfEnd += shelfHeight;
+        return AllocateFromShelf(static_cast<uint32_t>(m_shelves.size() - 1), paddedWidth, paddedHeight, rect);
+    }
+
+    // Page is nearly full; accept any shelf tall enough
+    for (uint32_t i = 0; i < m_shelves.size(); ++i) {
+        if (m_shelves[i].height >= paddedHeight && AllocateFromShelf(i, paddedWidth, paddedHeight, rect)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool UITextureAtlas::AllocateFromShelf(uint32_t shelfIndex, uint32_t width, uint32_t height, AtlasRect& rect) {
+    Shelf& shelf = m_shelves[shelfIndex];
+    for (auto it = shelf.freeSpans.begin(); it != shelf.freeSpans.end(); ++it) {
+        if (it->width < width) {
+            continue;
+        }
+
+        rect.x = it->x;
+        rect.y = shelf.y;
+        rect.width = width;
+        rect.height = height;
+
+        it->x += width;
+        it->width -= width;
+        if (it->width == 0) {
+            shelf.freeSpans.erase(it);
+        }
+
+        shelf.usedWidth += width;
+        ++m_allocationCount;
+        return true;
+    }
+    return false;
+}
+
+void UITextureAtlas::InsertShelf(uint32_t y, uint32_t height) {
+    Shelf shelf;
+    shelf.y = y;
+    shelf.height = height;
+    shelf.freeSpans.push_back({0, m_width});
+
+    auto position = std::lower_bound(m_shelves.begin(), m_shelves.end(), y,
+                                     [](const Shelf& s, uint32_t value) { return s.y < value; });
+    m_shelves.insert(position, std::move(shelf));
+}
+
+void UITextureAtlas::Free(const AtlasRect& rect) {
+    auto shelf = std::lower_bound(m_shelves.begin(), m_shelves.end(), rect.y,
+                                  [](const Shelf& s, uint32_t value) { return s.y < value; });
+    if (shelf == m_shelves.end() || shelf->y != rect.y) {
+        return;
+    }
+
+    // Return the span and coalesce with its neighbours
+    auto& spans = shelf->freeSpans;
+    auto next = std::lower_bound(spans.begin(), spans.end(), rect.x,
+                                 [](const Span& s, uint32_t value) { return s.x < value; });
+    next = spans.insert(next, {rect.x, rect.width});
+    if (next + 1 != spans.end() && next->x + next->width == (next + 1)->x) {
+        next->width += (next + 1)->width;
+        spans.erase(next + 1);
+    }
+    if (next != spans.begin() && (next - 1)->x + (next - 1)->width == next->x) {
+        (next - 1)->width += next->width;
+        spans.erase(next);
+    }
+
+    shelf->usedWidth -= rect.width;
+    --m_allocationCount;
+
+    if (shelf->usedWidth != 0) {
+        return;
+    }
+
+    // Merge with empty neighbours so the space can be cut again at any height
+    size_t index = static_cast<size_t>(shelf - m_shelves.begin());
+    if (index + 1 < m_shelves.size() && m_shelves[index + 1].usedWidth == 0) {
+        m_shelves[index].height += m_shelves[index + 1].height;
+        m_shelves.erase(m_shelves.begin() + index + 1);
+    }
+    if (index > 0 && m_shelves[index - 1].usedWidth == 0) {
+        m_shelves[index - 1].height += m_shelves[index].height;
+        m_shelves.erase(m_shelves.begin() + index);
+        --index;
+    }
+
+    // An empty shelf at the end goes back to the unused area
+    if (index + 1 == m_shelves.size()) {
+        m_shelfEnd = m_shelves[index].y;
+        m_shelves.pop_back();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Region of an atlas page, padding included
+struct AtlasRect {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+/**
+ * UITextureAtlas packs small UI images into one atlas page.
+ * This class handles:
+ * - Shelf packing: rows of similar height, filled left to right
+ * - Padding around every image so linear filtering does not bleed between neighbours
+ * - Reusing freed space: spans within a shelf coalesce, empty shelves are split or reclaimed
+ *
+ * Only the layout is managed here; the owner creates the page image and uploads into the
+ * returned rectangles. Rectangles include the padding; the image sits at (x + padding, y + padding).
+ */
+class UITextureAtlas {
+public:
+    UITextureAtlas(uint32_t width, uint32_t height, uint32_t padding);
+
+    bool Allocate(uint32_t width, uint32_t height, AtlasRect& rect);
+    void Free(const AtlasRect& rect);
+
+    bool IsEmpty() const { return m_allocationCount == 0; }
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    uint32_t GetPadding() const { return m_padding; }
+
+private:
+    struct Span {
+        uint32_t x;
+        uint32_t width;
+    };
+
+    struct Shelf {
+        uint32_t y;
+        uint32_t height;
+        uint32_t usedWidth = 0;
+        std::vector<Span> freeSpans;    // Sorted by x
+    };
+
+    // Shelf heights are rounded up so images of nearly equal height share shelves
+    static constexpr uint32_t SHELF_HEIGHT_STEP = 8;
+
+    bool AllocateFromShelf(uint32_t shelfIndex, uint32_t width, uint32_t height, AtlasRect& rect);
+    void InsertShelf(uint32_t y, uint32_t height);
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_padding;
+
+    std::vector<Shelf> m_shelves;   // Sorted by y, stacked from the top
+    uint32_t m_shelfEnd = 0;        // Top of the unused area below the last shelf
+    uint32_t m_allocationCount = 0;
+};
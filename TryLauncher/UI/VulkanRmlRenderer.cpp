@@ -1,16 +1,66 @@
 #include "VulkanRmlRenderer.h"
+#include "shaders/UIShaders.h"
 #include "../Vulkan/VulkanRenderer.h"
 #include "../Vulkan/ResourceManager.h"
 #include "../Vulkan/VulkanDevice.h"
+#include "../Vulkan/VulkanCommandBuffer.h"
+#include "../Core/JobSystem.h"
 #include <iostream>
 #include <array>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-VulkanRmlRenderer::VulkanRmlRenderer(VulkanRenderer* renderer, ResourceManager* resourceManager)
-    : m_renderer(renderer), m_resourceManager(resourceManager) {
+namespace {
+    VkRect2D UnionRect(const VkRect2D& a, const VkRect2D& b) {
+        int32_t left = std::min(a.offset.x, b.offset.x);
+        int32_t top = std::min(a.offset.y, b.offset.y);
+        int32_t right = std::max(a.offset.x + static_cast<int32_t>(a.extent.width),
+                                 b.offset.x + static_cast<int32_t>(b.extent.width));
+        int32_t bottom = std::max(a.offset.y + static_cast<int32_t>(a.extent.height),
+                                  b.offset.y + static_cast<int32_t>(b.extent.height));
+
+        VkRect2D result = {};
+        result.offset = {left, top};
+        result.extent = {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)};
+        return result;
+    }
+
+    bool IntersectRect(const VkRect2D& a, const VkRect2D& b, VkRect2D& result) {
+        int32_t left = std::max(a.offset.x, b.offset.x);
+        int32_t top = std::max(a.offset.y, b.offset.y);
+        int32_t right = std::min(a.offset.x + static_cast<int32_t>(a.extent.width),
+                                 b.offset.x + static_cast<int32_t>(b.extent.width));
+        int32_t bottom = std::min(a.offset.y + static_cast<int32_t>(a.extent.height),
+                                  b.offset.y + static_cast<int32_t>(b.extent.height));
+        if (right <= left || bottom <= top) {
+            return false;
+        }
+
+        result.offset = {left, top};
+        result.extent = {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)};
+        return true;
+    }
+
+    // FNV-1a, chained over the fields that decide a draw's pixels
+    uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+}
+
+VulkanRmlRenderer::VulkanRmlRenderer(VulkanRenderer* renderer, ResourceManager* resourceManager, JobSystem* jobSystem)
+    : m_renderer(renderer), m_resourceManager(resourceManager), m_jobSystem(jobSystem), m_geometryHeap(resourceManager),
+      m_drawRecorder(&m_geometryHeap) {
 }
 
 VulkanRmlRenderer::~VulkanRmlRenderer() {
@@ -27,6 +77,12 @@ bool VulkanRmlRenderer::Initialize() {
     std::cout << "Initializing VulkanRmlRenderer..." << std::endl;
 
     try {
+        // Bindless texturing needs descriptor indexing with room for the whole texture array
+        VulkanDevice* vulkanDevice = m_renderer->GetVulkanDevice();
+        m_bindless = vulkanDevice && vulkanDevice->SupportsDescriptorIndexing() &&
+                     vulkanDevice->GetMaxUpdateAfterBindSampledImages() >= BINDLESS_TEXTURE_CAPACITY;
+        std::cout << "UI textures use " << (m_bindless ? "a bindless descriptor array" : "one descriptor set each") << std::endl;
+
         // Create descriptor set layout
         if (!CreateDescriptorSetLayout()) {
             std::cerr << "Failed to create descriptor set layout" << std::endl;
@@ -39,6 +95,17 @@ bool VulkanRmlRenderer::Initialize() {
             return false;
         }
 
+        // The UI draws into its own target, so its pipelines never depend on the caller's render pass
+        if (!CreateTargetRenderPass() || !CreatePipelineVariants(m_targetRenderPass)) {
+            std::cerr << "Failed to create UI render target pipelines" << std::endl;
+            return false;
+        }
+
+        if (!CreateCompositeResources()) {
+            std::cerr << "Failed to create UI composite resources" << std::endl;
+            return false;
+        }
+
         // Create descriptor pool
         if (!CreateDescriptorPool()) {
             std::cerr << "Failed to create descriptor pool" << std::endl;
@@ -51,29 +118,14 @@ bool VulkanRmlRenderer::Initialize() {
             return false;
         }
 
-        // Create vertex buffer
-        m_vertexBuffer = m_resourceManager->CreateBuffer(
-            sizeof(UIVertex) * m_maxVertices,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU,
-            VMA_ALLOCATION_CREATE_MAPPED_BIT
-        );
-
-        if (!m_vertexBuffer.IsValid()) {
-            std::cerr << "Failed to create vertex buffer" << std::endl;
+        if (m_bindless && !CreateBindlessDescriptorSet()) {
+            std::cerr << "Failed to create bindless descriptor set" << std::endl;
             return false;
         }
 
-        // Create index buffer
-        m_indexBuffer = m_resourceManager->CreateBuffer(
-            sizeof(uint32_t) * m_maxIndices,
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-            VMA_MEMORY_USAGE_CPU_TO_GPU,
-            VMA_ALLOCATION_CREATE_MAPPED_BIT
-        );
-
-        if (!m_indexBuffer.IsValid()) {
-            std::cerr << "Failed to create index buffer" << std::endl;
+        // Suballocated storage for compiled geometry
+        if (!m_geometryHeap.Initialize()) {
+            std::cerr << "Failed to create geometry heap" << std::endl;
             return false;
         }
 
@@ -101,32 +153,53 @@ void VulkanRmlRenderer::Cleanup() {
 
     VkDevice device = m_renderer->GetDevice();
 
-    // Wait for device to be idle
+    // Drop uploads that were never submitted and let submitted ones finish
+    m_pendingUpload.batch.reset();
+    for (const AllocatedBuffer& stagingBuffer : m_pendingUpload.stagingBuffers) {
+        m_resourceManager->DestroyBuffer(stagingBuffer);
+    }
+    m_pendingUpload.stagingBuffers.clear();
+    RetireTextureUploads(true);
+
+    // Wait for device to be idle, then run deferred destructions; released textures are among them
     vkDeviceWaitIdle(device);
+    m_resourceManager->FlushRetired();
+    m_deferredGeometryReleases.clear();
+    m_deferredTextureReleases.clear();
+
+    // The current target was never retired
+    if (m_target.framebuffer != VK_NULL_HANDLE) {
+        vkDestroyFramebuffer(device, m_target.framebuffer, nullptr);
+    }
+    if (m_target.image.IsValid()) {
+        m_resourceManager->DestroyImage(m_target.image);
+    }
+    m_target = RenderTarget{};
 
     // Cleanup geometries
     for (auto& [handle, geometry] : m_geometries) {
-        m_resourceManager->DestroyBuffer(geometry->vertexBuffer);
-        m_resourceManager->DestroyBuffer(geometry->indexBuffer);
+        m_geometryHeap.Free(geometry->allocation);
     }
     m_geometries.clear();
+    m_geometryHeap.Shutdown();
 
     // Cleanup textures
     for (auto& [handle, texture] : m_textures) {
-        if (texture->sampler != VK_NULL_HANDLE) {
-            vkDestroySampler(device, texture->sampler, nullptr);
-        }
-        m_resourceManager->DestroyImage(texture->image);
+        DestroyTexture(texture.get());
     }
     m_textures.clear();
 
-    // Cleanup buffers
-    if (m_vertexBuffer.IsValid()) {
-        m_resourceManager->DestroyBuffer(m_vertexBuffer);
+    if (m_defaultTexture) {
+        DestroyTexture(m_defaultTexture);
+        delete m_defaultTexture;
+        m_defaultTexture = nullptr;
     }
-    if (m_indexBuffer.IsValid()) {
-        m_resourceManager->DestroyBuffer(m_indexBuffer);
+
+    // Pages go last; their entries above only returned space to them
+    for (auto& page : m_atlasPages) {
+        DestroyTexture(page->texture.get());
     }
+    m_atlasPages.clear();
 
     // Cleanup Vulkan objects
     if (m_defaultSampler != VK_NULL_HANDLE) {
@@ -137,11 +210,61 @@ void VulkanRmlRenderer::Cleanup() {
     if (m_descriptorPool != VK_NULL_HANDLE) {
         vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
         m_descriptorPool = VK_NULL_HANDLE;
+        m_descriptorSet = VK_NULL_HANDLE;
+    }
+    m_freeTextureSlots.clear();
+
+    for (VkPipeline& pipeline : m_pipelines) {
+        if (pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, pipeline, nullptr);
+            pipeline = VK_NULL_HANDLE;
+        }
+    }
+
+    if (m_compositePipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, m_compositePipeline, nullptr);
+        m_compositePipeline = VK_NULL_HANDLE;
+    }
+    m_compositeRenderPass = VK_NULL_HANDLE;
+
+    if (m_compositePipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, m_compositePipelineLayout, nullptr);
+        m_compositePipelineLayout = VK_NULL_HANDLE;
+    }
+
+    if (m_compositeDescriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, m_compositeDescriptorPool, nullptr);
+        m_compositeDescriptorPool = VK_NULL_HANDLE;
+    }
+
+    if (m_compositeSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, m_compositeSetLayout, nullptr);
+        m_compositeSetLayout = VK_NULL_HANDLE;
     }
 
-    if (m_pipeline != VK_NULL_HANDLE) {
-        vkDestroyPipeline(device, m_pipeline, nullptr);
-        m_pipeline = VK_NULL_HANDLE;
+    if (m_compositeVertexShader != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device, m_compositeVertexShader, nullptr);
+        m_compositeVertexShader = VK_NULL_HANDLE;
+    }
+
+    if (m_compositeFragmentShader != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device, m_compositeFragmentShader, nullptr);
+        m_compositeFragmentShader = VK_NULL_HANDLE;
+    }
+
+    if (m_targetRenderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(device, m_targetRenderPass, nullptr);
+        m_targetRenderPass = VK_NULL_HANDLE;
+    }
+
+    if (m_vertexShader != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device, m_vertexShader, nullptr);
+        m_vertexShader = VK_NULL_HANDLE;
+    }
+
+    if (m_fragmentShader != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device, m_fragmentShader, nullptr);
+        m_fragmentShader = VK_NULL_HANDLE;
     }
 
     if (m_pipelineLayout != VK_NULL_HANDLE) {
@@ -158,37 +281,76 @@ void VulkanRmlRenderer::Cleanup() {
     std::cout << "VulkanRmlRenderer cleanup complete" << std::endl;
 }
 
-void VulkanRmlRenderer::BeginFrame(VkCommandBuffer commandBuffer, VkRenderPass renderPass,
-                                  uint32_t framebufferWidth, uint32_t framebufferHeight) {
+void VulkanRmlRenderer::BeginFrame(VkCommandBuffer commandBuffer, uint32_t framebufferWidth, uint32_t framebufferHeight) {
+    // Called after the frame slot's timeline wait, so older frames' geometry can be recycled
+    m_geometryHeap.BeginFrame();
+
     m_currentCommandBuffer = commandBuffer;
-    m_currentRenderPass = renderPass;
     m_framebufferWidth = framebufferWidth;
     m_framebufferHeight = framebufferHeight;
 
-    // Set up viewport and scissor
+    // The target follows the framebuffer; a new one starts out fully damaged
+    bool sizeChanged = m_target.image.extent.width != framebufferWidth ||
+                       m_target.image.extent.height != framebufferHeight;
+    if (framebufferWidth > 0 && framebufferHeight > 0 && (sizeChanged || !m_target.image.IsValid()) &&
+        !CreateRenderTarget(framebufferWidth, framebufferHeight)) {
+        std::cerr << "UI render target unavailable; UI draws are skipped" << std::endl;
+    }
+    m_damageTracker.BeginFrame(framebufferWidth, framebufferHeight);
+
+    // Set up projection matrix for UI rendering
+    m_currentTransform = glm::ortho(0.0f, static_cast<float>(framebufferWidth),
+                                   static_cast<float>(framebufferHeight), 0.0f,
+                                   -1.0f, 1.0f);
+
+    m_drawRecorder.Reset(framebufferWidth, framebufferHeight, m_currentTransform);
+    m_drawRecorder.SetScissor(m_scissorEnabled, m_scissorRect);
+}
+
+void VulkanRmlRenderer::EndFrame() {
+    // Draws are only issued now that the whole frame is known and can be diffed against the last one
+    const std::vector<VkRect2D>& damage = m_damageTracker.EndFrame();
+    if (damage.empty() || m_target.framebuffer == VK_NULL_HANDLE) {
+        m_drawRecorder.Discard();
+    } else {
+        RenderDamage(damage);
+    }
+
+    FreeDeferredReleases();
+
+    // RmlUi creates textures while rendering; submit them ahead of the frame that samples them
+    FlushTextureUploads();
+
+    m_currentCommandBuffer = VK_NULL_HANDLE;
+}
+
+void VulkanRmlRenderer::Composite(VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+                                  uint32_t framebufferWidth, uint32_t framebufferHeight) {
+    // Nothing has been drawn into the target yet
+    if (!m_initialized || m_target.layout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+        return;
+    }
+
+    // The composite pipeline is tied to the caller's render pass, e.g. a new one after a swapchain rebuild
+    if (renderPass != m_compositeRenderPass && !CreateCompositePipeline(renderPass)) {
+        std::cerr << "UI composite pipeline unavailable; the UI is not shown" << std::endl;
+        return;
+    }
+
     VkViewport viewport = {};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
     viewport.width = static_cast<float>(framebufferWidth);
     viewport.height = static_cast<float>(framebufferHeight);
-    viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
     VkRect2D scissor = {};
-    scissor.offset = {0, 0};
     scissor.extent = {framebufferWidth, framebufferHeight};
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-    // Set up projection matrix for UI rendering
-    m_currentTransform = glm::ortho(0.0f, static_cast<float>(framebufferWidth),
-                                   static_cast<float>(framebufferHeight), 0.0f,
-                                   -1.0f, 1.0f);
-}
-
-void VulkanRmlRenderer::EndFrame() {
-    m_currentCommandBuffer = VK_NULL_HANDLE;
-    m_currentRenderPass = VK_NULL_HANDLE;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_compositePipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_compositePipelineLayout,
+                            0, 1, &m_target.compositeSet, 0, nullptr);
+    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
 }
 
 Rml::CompiledGeometryHandle VulkanRmlRenderer::CompileGeometry(Rml::Span<const Rml::Vertex> vertices, Rml::Span<const int> indices) {
@@ -199,67 +361,37 @@ Rml::CompiledGeometryHandle VulkanRmlRenderer::CompileGeometry(Rml::Span<const R
     // Create compiled geometry
     auto geometry = std::make_unique<CompiledGeometry>();
     
-    // Create vertex buffer
-    VkDeviceSize vertexBufferSize = sizeof(UIVertex) * vertices.size();
-    geometry->vertexBuffer = m_resourceManager->CreateBuffer(
-        vertexBufferSize,
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VMA_MEMORY_USAGE_CPU_TO_GPU,
-        VMA_ALLOCATION_CREATE_MAPPED_BIT
-    );
-    
-    if (!geometry->vertexBuffer.IsValid()) {
-        return 0;
-    }
-    
-    // Create index buffer
-    VkDeviceSize indexBufferSize = sizeof(uint32_t) * indices.size();
-    geometry->indexBuffer = m_resourceManager->CreateBuffer(
-        indexBufferSize,
-        VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VMA_MEMORY_USAGE_CPU_TO_GPU,
-        VMA_ALLOCATION_CREATE_MAPPED_BIT
-    );
+    VkDeviceSize vertexDataSize = sizeof(Rml::Vertex) * vertices.size();
+    VkDeviceSize indexDataSize = sizeof(uint32_t) * indices.size();
+    geometry->indexOffset = vertexDataSize; // 20-byte vertices keep this 4-byte aligned for the index data
     
-    if (!geometry->indexBuffer.IsValid()) {
-        m_resourceManager->DestroyBuffer(geometry->vertexBuffer);
+    if (!m_geometryHeap.Allocate(vertexDataSize + indexDataSize, geometry->allocation)) {
         return 0;
     }
     
-    // Convert and copy vertex data
-    std::vector<UIVertex> uiVertices(vertices.size());
-    for (size_t i = 0; i < vertices.size(); ++i) {
-        const Rml::Vertex& rmlVertex = vertices[i];
-        UIVertex& uiVertex = uiVertices[i];
-        
-        uiVertex.position = glm::vec2(rmlVertex.position.x, rmlVertex.position.y);
-        uiVertex.color = glm::vec4(
-            rmlVertex.colour.red / 255.0f,
-            rmlVertex.colour.green / 255.0f,
-            rmlVertex.colour.blue / 255.0f,
-            rmlVertex.colour.alpha / 255.0f
-        );
-        uiVertex.texCoord = glm::vec2(rmlVertex.tex_coord.x, rmlVertex.tex_coord.y);
-    }
-    
-    // Copy vertex data to buffer
-    void* vertexData = m_resourceManager->MapBuffer(geometry->vertexBuffer);
-    if (vertexData) {
-        memcpy(vertexData, uiVertices.data(), vertexBufferSize);
-        m_resourceManager->FlushBuffer(geometry->vertexBuffer, 0, vertexBufferSize);
-        m_resourceManager->UnmapBuffer(geometry->vertexBuffer);
-    }
-    
-    // Copy index data to buffer
-    void* indexData = m_resourceManager->MapBuffer(geometry->indexBuffer);
-    if (indexData) {
-        memcpy(indexData, indices.data(), indexBufferSize);
-        m_resourceManager->FlushBuffer(geometry->indexBuffer, 0, indexBufferSize);
-        m_resourceManager->UnmapBuffer(geometry->indexBuffer);
-    }
+    // Vertex format matches Rml::Vertex, so both arrays go straight into mapped memory
+    memcpy(geometry->allocation.data, vertices.data(), vertexDataSize);
+    memcpy(geometry->allocation.data + geometry->indexOffset, indices.data(), indexDataSize);
+    m_geometryHeap.Flush(geometry->allocation);
     
     geometry->vertexCount = static_cast<uint32_t>(vertices.size());
     geometry->indexCount = static_cast<uint32_t>(indices.size());
+
+    // Local extent, so each draw's screen rectangle is a transform of four corners
+    if (!vertices.empty()) {
+        geometry->boundsMin = geometry->boundsMax = glm::vec2(vertices[0].position.x, vertices[0].position.y);
+        for (const Rml::Vertex& vertex : vertices) {
+            glm::vec2 position(vertex.position.x, vertex.position.y);
+            geometry->boundsMin = glm::min(geometry->boundsMin, position);
+            geometry->boundsMax = glm::max(geometry->boundsMax, position);
+        }
+    }
+
+    // Small geometry (text quads, borders) is what gets merged; keep a copy to merge from
+    if (geometry->vertexCount <= UIDrawRecorder::MAX_MERGE_VERTICES) {
+        geometry->vertices.assign(vertices.begin(), vertices.end());
+        geometry->indices.assign(indices.begin(), indices.end());
+    }
     
     // Store geometry and return handle
     Rml::CompiledGeometryHandle handle = m_nextGeometryHandle++;
@@ -279,48 +411,51 @@ void VulkanRmlRenderer::RenderGeometry(Rml::CompiledGeometryHandle geometry, Rml
     }
     
     const CompiledGeometry* geom = it->second.get();
-    
-    // Bind pipeline (placeholder - needs actual pipeline implementation)
-    // BindPipeline();
-    
-    // Bind vertex buffer
-    VkBuffer vertexBuffers[] = {geom->vertexBuffer.buffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(m_currentCommandBuffer, 0, 1, vertexBuffers, offsets);
-    
-    // Bind index buffer
-    vkCmdBindIndexBuffer(m_currentCommandBuffer, geom->indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
-    
-    // Set push constants
-    UIPushConstants pushConstants = {};
-    pushConstants.transform = m_currentTransform;
-    pushConstants.translation = glm::vec2(translation.x, translation.y);
-    pushConstants.useTexture = (texture != 0) ? 1 : 0;
-    
-    // TODO: Implement actual pipeline and push constants
-    // vkCmdPushConstants(m_currentCommandBuffer, m_pipelineLayout,
-    //                   VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-    //                   0, sizeof(UIPushConstants), &pushConstants);
-    
-    // Apply scissor if enabled
-    if (m_scissorEnabled) {
-        vkCmdSetScissor(m_currentCommandBuffer, 0, 1, &m_scissorRect);
+    if (!geom->allocation.IsValid()) {
+        return;
     }
     
-    // Draw indexed
-    vkCmdDrawIndexed(m_currentCommandBuffer, geom->indexCount, 1, 0, 0, 0);
+    // Entries of one atlas page can be merged into a single draw; untextured draws form their own group
+    const TextureResource* resource = ResolveTexture(texture);
+    uintptr_t textureGroup = 0;
+    glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
+    if (resource) {
+        uvRect = resource->uvRect;
+        if (texture != 0) {
+            textureGroup = resource->atlasPage ? reinterpret_cast<uintptr_t>(resource->atlasPage)
+                                               : reinterpret_cast<uintptr_t>(resource);
+        }
+    }
+
+    // Recorded with the current transform and scissor; EndFrame issues the commands
+    glm::vec2 offset(translation.x, translation.y);
+    VkRect2D bounds = ComputeDrawBounds(*geom, offset);
+    m_drawRecorder.Record(geom->allocation, geom->indexOffset, geom->indexCount,
+                          geom->vertices.empty() ? nullptr : geom->vertices.data(),
+                          geom->vertexCount,
+                          geom->indices.empty() ? nullptr : geom->indices.data(),
+                          offset, texture, textureGroup, uvRect, bounds);
+
+    // Geometry handles are never reused and textures never change contents, so equal keys
+    // in consecutive frames paint equal pixels
+    VkRect2D scissor = m_scissorEnabled ? m_scissorRect : VkRect2D{{0, 0}, {m_framebufferWidth, m_framebufferHeight}};
+    uint64_t key = 0xcbf29ce484222325ull;
+    key = HashBytes(key, &geometry, sizeof(geometry));
+    key = HashBytes(key, &texture, sizeof(texture));
+    key = HashBytes(key, &offset, sizeof(offset));
+    key = HashBytes(key, &m_currentTransform, sizeof(m_currentTransform));
+    key = HashBytes(key, &scissor, sizeof(scissor));
+    m_damageTracker.Record(key, bounds);
 }
 
 void VulkanRmlRenderer::ReleaseGeometry(Rml::CompiledGeometryHandle geometry) {
-    auto it = m_geometries.find(geometry);
-    if (it != m_geometries.end()) {
-        // Cleanup buffers
-        m_resourceManager->DestroyBuffer(it->second->vertexBuffer);
-        m_resourceManager->DestroyBuffer(it->second->indexBuffer);
-        
-        // Remove from map
-        m_geometries.erase(it);
+    // Recorded draws may still merge from its CPU copy; they are issued at EndFrame
+    if (m_drawRecorder.HasPendingDraws()) {
+        m_deferredGeometryReleases.push_back(geometry);
+        return;
     }
+
+    FreeGeometry(geometry);
 }
 
 Rml::TextureHandle VulkanRmlRenderer::LoadTexture(Rml::Vector2i& texture_dimensions,
@@ -369,15 +504,13 @@ Rml::TextureHandle VulkanRmlRenderer::GenerateTexture(Rml::Span<const Rml::byte>
 }
 
 void VulkanRmlRenderer::ReleaseTexture(Rml::TextureHandle texture) {
-    auto it = m_textures.find(texture);
-    if (it != m_textures.end()) {
-        VkDevice device = m_renderer->GetDevice();
-        if (it->second->sampler != VK_NULL_HANDLE) {
-            vkDestroySampler(device, it->second->sampler, nullptr);
-        }
-        m_resourceManager->DestroyImage(it->second->image);
-        m_textures.erase(it);
+    // Recorded draws look the texture up when EndFrame issues them
+    if (m_drawRecorder.HasPendingDraws()) {
+        m_deferredTextureReleases.push_back(texture);
+        return;
     }
+
+    FreeTexture(texture);
 }
 
 void VulkanRmlRenderer::SetTransform(const Rml::Matrix4f* transform) {
@@ -396,10 +529,13 @@ void VulkanRmlRenderer::SetTransform(const Rml::Matrix4f* transform) {
                                        static_cast<float>(m_framebufferHeight), 0.0f,
                                        -1.0f, 1.0f);
     }
+
+    m_drawRecorder.SetTransform(m_currentTransform);
 }
 
 void VulkanRmlRenderer::EnableScissorRegion(bool enable) {
     m_scissorEnabled = enable;
+    m_drawRecorder.SetScissor(m_scissorEnabled, m_scissorRect);
 }
 
 void VulkanRmlRenderer::SetScissorRegion(Rml::Rectanglei region) {
@@ -414,47 +550,85 @@ void VulkanRmlRenderer::SetScissorRegion(Rml::Rectanglei region) {
     m_scissorRect.extent.height = std::min(m_scissorRect.extent.height,
                                           m_framebufferHeight - m_scissorRect.offset.y);
 
-    if (m_currentCommandBuffer && m_scissorEnabled) {
-        vkCmdSetScissor(m_currentCommandBuffer, 0, 1, &m_scissorRect);
-    }
+    m_drawRecorder.SetScissor(m_scissorEnabled, m_scissorRect);
 }
 
 // Private helper methods implementation will continue in next part...
 // Private helper methods implementation
 
-VkVertexInputBindingDescription VulkanRmlRenderer::UIVertex::GetBindingDescription() {
+static_assert(sizeof(Rml::Vertex) == 20, "UI vertex input expects the packed Rml::Vertex layout");
+static_assert(sizeof(Rml::Vertex::colour) == 4, "UI vertex colour is read as R8G8B8A8_UNORM");
+
+VkVertexInputBindingDescription VulkanRmlRenderer::GetVertexBindingDescription() {
     VkVertexInputBindingDescription bindingDescription = {};
     bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(UIVertex);
+    bindingDescription.stride = sizeof(Rml::Vertex);
     bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
     return bindingDescription;
 }
 
-std::array<VkVertexInputAttributeDescription, 3> VulkanRmlRenderer::UIVertex::GetAttributeDescriptions() {
+std::array<VkVertexInputAttributeDescription, 3> VulkanRmlRenderer::GetVertexAttributeDescriptions() {
     std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions = {};
 
     // Position
     attributeDescriptions[0].binding = 0;
     attributeDescriptions[0].location = 0;
     attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescriptions[0].offset = offsetof(UIVertex, position);
+    attributeDescriptions[0].offset = offsetof(Rml::Vertex, position);
 
-    // Color
+    // Color, normalized to 0..1 by the vertex fetch
     attributeDescriptions[1].binding = 0;
     attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[1].offset = offsetof(UIVertex, color);
+    attributeDescriptions[1].format = VK_FORMAT_R8G8B8A8_UNORM;
+    attributeDescriptions[1].offset = offsetof(Rml::Vertex, colour);
 
     // Texture coordinates
     attributeDescriptions[2].binding = 0;
     attributeDescriptions[2].location = 2;
     attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescriptions[2].offset = offsetof(UIVertex, texCoord);
+    attributeDescriptions[2].offset = offsetof(Rml::Vertex, tex_coord);
 
     return attributeDescriptions;
 }
 
 bool VulkanRmlRenderer::CreateDescriptorSetLayout() {
+    if (m_bindless) {
+        // One sampler shared by every texture, and the texture array itself
+        std::array<VkDescriptorSetLayoutBinding, 2> bindings = {};
+        bindings[0].binding = 0;
+        bindings[0].descriptorCount = 1;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        bindings[1].binding = 1;
+        bindings[1].descriptorCount = BINDLESS_TEXTURE_CAPACITY;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        // Slots are filled as textures arrive, while frames in flight keep using the set
+        std::array<VkDescriptorBindingFlagsEXT, 2> bindingFlags = {
+            0,
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT
+        };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = &bindingFlagsInfo;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+
+        VkResult result = vkCreateDescriptorSetLayout(m_renderer->GetDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout);
+        return result == VK_SUCCESS;
+    }
+
     VkDescriptorSetLayoutBinding samplerLayoutBinding = {};
     samplerLayoutBinding.binding = 0;
     samplerLayoutBinding.descriptorCount = 1;
@@ -472,60 +646,496 @@ bool VulkanRmlRenderer::CreateDescriptorSetLayout() {
 }
 
 bool VulkanRmlRenderer::CreatePipeline() {
-    // Create shader modules (placeholder - you'll need actual shader code)
-    const char* vertexShaderCode = R"(
-        #version 450
-        
-        layout(location = 0) in vec2 inPosition;
-        layout(location = 1) in vec4 inColor;
-        layout(location = 2) in vec2 inTexCoord;
-        
-        layout(push_constant) uniform PushConstants {
-            mat4 transform;
-            vec2 translation;
-            int useTexture;
-        } pc;
-        
-        layout(location = 0) out vec4 fragColor;
-        layout(location = 1) out vec2 fragTexCoord;
-        layout(location = 2) out flat int fragUseTexture;
-        
-        void main() {
-            vec2 pos = inPosition + pc.translation;
-            gl_Position = pc.transform * vec4(pos, 0.0, 1.0);
-            fragColor = inColor;
-            fragTexCoord = inTexCoord;
-            fragUseTexture = pc.useTexture;
-        }
-    )";
+    // SPIR-V is compiled with the project and embedded; in bindless mode the fragment stage
+    // reads the texture array instead of a per-texture set
+    m_vertexShader = CreateShaderModule(UIShaders::Vertex, sizeof(UIShaders::Vertex));
+    m_fragmentShader = m_bindless ? CreateShaderModule(UIShaders::BindlessFragment, sizeof(UIShaders::BindlessFragment))
+                                  : CreateShaderModule(UIShaders::Fragment, sizeof(UIShaders::Fragment));
+    if (m_vertexShader == VK_NULL_HANDLE || m_fragmentShader == VK_NULL_HANDLE) {
+        std::cerr << "Failed to create UI shader modules" << std::endl;
+        return false;
+    }
 
-    const char* fragmentShaderCode = R"(
-        #version 450
-        
-        layout(location = 0) in vec4 fragColor;
-        layout(location = 1) in vec2 fragTexCoord;
-        layout(location = 2) in flat int fragUseTexture;
-        
-        layout(binding = 0) uniform sampler2D texSampler;
-        
-        layout(location = 0) out vec4 outColor;
-        
-        void main() {
-            if (fragUseTexture != 0) {
-                outColor = fragColor * texture(texSampler, fragTexCoord);
-            } else {
-                outColor = fragColor;
-            }
+    VkPushConstantRange pushConstantRange = {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(UIPushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &m_descriptorSetLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    VkResult result = vkCreatePipelineLayout(m_renderer->GetDevice(), &layoutInfo, nullptr, &m_pipelineLayout);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI pipeline layout: " << result << std::endl;
+        return false;
+    }
+
+    // The pipelines themselves are built against the target render pass
+    return true;
+}
+
+bool VulkanRmlRenderer::CreatePipelineVariants(VkRenderPass renderPass) {
+    RetirePipelineVariants();
+
+    VkVertexInputBindingDescription bindingDescription = GetVertexBindingDescription();
+    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions = GetVertexAttributeDescriptions();
+
+    VkPipelineVertexInputStateCreateInfo vertexInput = {};
+    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInput.vertexBindingDescriptionCount = 1;
+    vertexInput.pVertexBindingDescriptions = &bindingDescription;
+    vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+    vertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    // Viewport and scissor are dynamic
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling = {};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_FALSE;
+    depthStencil.depthWriteEnable = VK_FALSE;
+
+    // RmlUi vertex colours are premultiplied by alpha
+    VkPipelineColorBlendAttachmentState blendAttachment = {};
+    blendAttachment.blendEnable = VK_TRUE;
+    blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                     VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending = {};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &blendAttachment;
+
+    std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    // One specialization constant per variant bit, in constant_id order
+    VkSpecializationMapEntry specializationEntry = {};
+    specializationEntry.constantID = 0;
+    specializationEntry.offset = 0;
+    specializationEntry.size = sizeof(VkBool32);
+
+    std::array<VkBool32, PIPELINE_VARIANT_COUNT> specializationData = {};
+    std::array<VkSpecializationInfo, PIPELINE_VARIANT_COUNT> specializationInfos = {};
+    std::array<std::array<VkPipelineShaderStageCreateInfo, 2>, PIPELINE_VARIANT_COUNT> stages = {};
+    std::array<VkGraphicsPipelineCreateInfo, PIPELINE_VARIANT_COUNT> pipelineInfos = {};
+
+    for (uint32_t variant = 0; variant < PIPELINE_VARIANT_COUNT; ++variant) {
+        specializationData[variant] = (variant & PIPELINE_VARIANT_TEXTURED) ? VK_TRUE : VK_FALSE;
+
+        VkSpecializationInfo& specialization = specializationInfos[variant];
+        specialization.mapEntryCount = 1;
+        specialization.pMapEntries = &specializationEntry;
+        specialization.dataSize = sizeof(VkBool32);
+        specialization.pData = &specializationData[variant];
+
+        stages[variant][0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[variant][0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[variant][0].module = m_vertexShader;
+        stages[variant][0].pName = "main";
+
+        stages[variant][1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[variant][1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[variant][1].module = m_fragmentShader;
+        stages[variant][1].pName = "main";
+        stages[variant][1].pSpecializationInfo = &specialization;
+
+        VkGraphicsPipelineCreateInfo& pipelineInfo = pipelineInfos[variant];
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = static_cast<uint32_t>(stages[variant].size());
+        pipelineInfo.pStages = stages[variant].data();
+        pipelineInfo.pVertexInputState = &vertexInput;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = &depthStencil;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = m_pipelineLayout;
+        pipelineInfo.renderPass = renderPass;
+        pipelineInfo.subpass = 0;
+    }
+
+    // All variants in one call, through the shared cache so later launches skip compilation
+    VkResult result = vkCreateGraphicsPipelines(m_renderer->GetDevice(), m_renderer->GetPipelineCache(),
+                                                static_cast<uint32_t>(pipelineInfos.size()), pipelineInfos.data(),
+                                                nullptr, m_pipelines.data());
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI pipelines: " << result << std::endl;
+        // Pipelines that did get created are still valid handles
+        RetirePipelineVariants();
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanRmlRenderer::RetirePipelineVariants() {
+    // Frames in flight may still be drawing with them
+    VkDevice device = m_renderer->GetDevice();
+    for (VkPipeline& pipeline : m_pipelines) {
+        if (pipeline != VK_NULL_HANDLE) {
+            VkPipeline retired = pipeline;
+            m_resourceManager->Retire([device, retired]() {
+                vkDestroyPipeline(device, retired, nullptr);
+            });
+            pipeline = VK_NULL_HANDLE;
         }
-    )";
+    }
+}
 
-    // TODO: Compile shaders and create pipeline
-    // For now, return true as placeholder
-    std::cout << "Pipeline creation placeholder - implement shader compilation" << std::endl;
+bool VulkanRmlRenderer::CreateTargetRenderPass() {
+    // Loads the target: pixels outside this frame's damage are kept from earlier frames
+    VkAttachmentDescription colorAttachment = {};
+    colorAttachment.format = TARGET_FORMAT;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference colorAttachmentRef = {};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+
+    // The composite pass samples what this one wrote
+    VkSubpassDependency dependency = {};
+    dependency.srcSubpass = 0;
+    dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    VkRenderPassCreateInfo renderPassInfo = {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies = &dependency;
+
+    VkResult result = vkCreateRenderPass(m_renderer->GetDevice(), &renderPassInfo, nullptr, &m_targetRenderPass);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI target render pass: " << result << std::endl;
+        return false;
+    }
     return true;
 }
 
+bool VulkanRmlRenderer::CreateCompositeResources() {
+    VkDevice device = m_renderer->GetDevice();
+
+    m_compositeVertexShader = CreateShaderModule(UIShaders::CompositeVertex, sizeof(UIShaders::CompositeVertex));
+    m_compositeFragmentShader = CreateShaderModule(UIShaders::CompositeFragment, sizeof(UIShaders::CompositeFragment));
+    if (m_compositeVertexShader == VK_NULL_HANDLE || m_compositeFragmentShader == VK_NULL_HANDLE) {
+        std::cerr << "Failed to create UI composite shader modules" << std::endl;
+        return false;
+    }
+
+    VkDescriptorSetLayoutBinding samplerBinding = {};
+    samplerBinding.binding = 0;
+    samplerBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    samplerBinding.descriptorCount = 1;
+    samplerBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+    setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    setLayoutInfo.bindingCount = 1;
+    setLayoutInfo.pBindings = &samplerBinding;
+
+    VkResult result = vkCreateDescriptorSetLayout(device, &setLayoutInfo, nullptr, &m_compositeSetLayout);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI composite descriptor set layout: " << result << std::endl;
+        return false;
+    }
+
+    // Sets are freed when their target is retired, so a resize does not leak them
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = COMPOSITE_SET_CAPACITY;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.maxSets = COMPOSITE_SET_CAPACITY;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    result = vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_compositeDescriptorPool);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI composite descriptor pool: " << result << std::endl;
+        return false;
+    }
+
+    VkPipelineLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &m_compositeSetLayout;
+
+    result = vkCreatePipelineLayout(device, &layoutInfo, nullptr, &m_compositePipelineLayout);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI composite pipeline layout: " << result << std::endl;
+        return false;
+    }
+
+    // The pipeline itself needs the caller's render pass, which arrives with the first Composite
+    return true;
+}
+
+bool VulkanRmlRenderer::CreateCompositePipeline(VkRenderPass renderPass) {
+    // Frames in flight may still be compositing with the old one
+    if (m_compositePipeline != VK_NULL_HANDLE) {
+        VkDevice device = m_renderer->GetDevice();
+        VkPipeline retired = m_compositePipeline;
+        m_resourceManager->Retire([device, retired]() {
+            vkDestroyPipeline(device, retired, nullptr);
+        });
+        m_compositePipeline = VK_NULL_HANDLE;
+        m_compositeRenderPass = VK_NULL_HANDLE;
+    }
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> stages = {};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = m_compositeVertexShader;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = m_compositeFragmentShader;
+    stages[1].pName = "main";
+
+    // The triangle is generated from gl_VertexIndex
+    VkPipelineVertexInputStateCreateInfo vertexInput = {};
+    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling = {};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+    // The target holds premultiplied colour, like the geometry drawn into it
+    VkPipelineColorBlendAttachmentState blendAttachment = {};
+    blendAttachment.blendEnable = VK_TRUE;
+    blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                     VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending = {};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &blendAttachment;
+
+    std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+    pipelineInfo.pStages = stages.data();
+    pipelineInfo.pVertexInputState = &vertexInput;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_compositePipelineLayout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+
+    VkResult result = vkCreateGraphicsPipelines(m_renderer->GetDevice(), m_renderer->GetPipelineCache(),
+                                                1, &pipelineInfo, nullptr, &m_compositePipeline);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI composite pipeline: " << result << std::endl;
+        m_compositePipeline = VK_NULL_HANDLE;
+        return false;
+    }
+
+    m_compositeRenderPass = renderPass;
+    return true;
+}
+
+bool VulkanRmlRenderer::CreateRenderTarget(uint32_t width, uint32_t height) {
+    RetireRenderTarget();
+
+    VkDevice device = m_renderer->GetDevice();
+    RenderTarget target;
+    target.image = m_resourceManager->CreateImage2D(width, height, TARGET_FORMAT,
+                                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+    if (!target.image.IsValid()) {
+        std::cerr << "Failed to create UI render target image" << std::endl;
+        return false;
+    }
+
+    VkFramebufferCreateInfo framebufferInfo = {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = m_targetRenderPass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments = &target.image.imageView;
+    framebufferInfo.width = width;
+    framebufferInfo.height = height;
+    framebufferInfo.layers = 1;
+
+    VkResult result = vkCreateFramebuffer(device, &framebufferInfo, nullptr, &target.framebuffer);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create UI render target framebuffer: " << result << std::endl;
+        m_resourceManager->DestroyImage(target.image);
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_compositeDescriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_compositeSetLayout;
+
+    result = vkAllocateDescriptorSets(device, &allocInfo, &target.compositeSet);
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to allocate UI composite descriptor set: " << result << std::endl;
+        vkDestroyFramebuffer(device, target.framebuffer, nullptr);
+        m_resourceManager->DestroyImage(target.image);
+        return false;
+    }
+
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = m_defaultSampler;
+    imageInfo.imageView = target.image.imageView;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = target.compositeSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+
+    // Contents start undefined, so the first frame redraws everything
+    m_target = target;
+    m_damageTracker.InvalidateAll();
+    return true;
+}
+
+void VulkanRmlRenderer::RetireRenderTarget() {
+    if (!m_target.image.IsValid()) {
+        return;
+    }
+
+    // Frames in flight may still be drawing into or compositing it
+    VkDevice device = m_renderer->GetDevice();
+    RenderTarget retired = m_target;
+    VkDescriptorPool pool = m_compositeDescriptorPool;
+    ResourceManager* resourceManager = m_resourceManager;
+    m_resourceManager->Retire([device, retired, pool, resourceManager]() {
+        vkDestroyFramebuffer(device, retired.framebuffer, nullptr);
+        vkFreeDescriptorSets(device, pool, 1, &retired.compositeSet);
+        resourceManager->DestroyImage(retired.image);
+    });
+    m_target = RenderTarget{};
+}
+
+VkShaderModule VulkanRmlRenderer::CreateShaderModule(const uint32_t* code, size_t size) {
+    VkShaderModuleCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = size;
+    createInfo.pCode = code;
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(m_renderer->GetDevice(), &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    return shaderModule;
+}
+
 bool VulkanRmlRenderer::CreateDescriptorPool() {
+    if (m_bindless) {
+        // Holds the single bindless set
+        std::array<VkDescriptorPoolSize, 2> poolSizes = {};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+        poolSizes[0].descriptorCount = 1;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        poolSizes[1].descriptorCount = BINDLESS_TEXTURE_CAPACITY;
+
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+        poolInfo.maxSets = 1;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+
+        VkResult result = vkCreateDescriptorPool(m_renderer->GetDevice(), &poolInfo, nullptr, &m_descriptorPool);
+        return result == VK_SUCCESS;
+    }
+
     VkDescriptorPoolSize poolSize = {};
     poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     poolSize.descriptorCount = 1000; // Support many textures
@@ -541,6 +1151,37 @@ bool VulkanRmlRenderer::CreateDescriptorPool() {
     return result == VK_SUCCESS;
 }
 
+bool VulkanRmlRenderer::CreateBindlessDescriptorSet() {
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(m_renderer->GetDevice(), &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+        return false;
+    }
+
+    VkDescriptorImageInfo samplerInfo = {};
+    samplerInfo.sampler = m_defaultSampler;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_descriptorSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    write.pImageInfo = &samplerInfo;
+    vkUpdateDescriptorSets(m_renderer->GetDevice(), 1, &write, 0, nullptr);
+
+    // Lowest slots first, so the default texture lands in slot 0
+    m_freeTextureSlots.clear();
+    for (uint32_t slot = BINDLESS_TEXTURE_CAPACITY; slot > 0; --slot) {
+        m_freeTextureSlots.push_back(slot - 1);
+    }
+    return true;
+}
+
 bool VulkanRmlRenderer::CreateSampler() {
     VkSamplerCreateInfo samplerInfo = {};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -572,55 +1213,18 @@ bool VulkanRmlRenderer::CreateDefaultTexture() {
     return m_defaultTexture != nullptr;
 }
 
-void VulkanRmlRenderer::UpdateVertexBuffer(Rml::Vertex* vertices, int num_vertices) {
-    if (!m_vertexBuffer.IsValid() || num_vertices == 0) {
-        return;
-    }
-
-    // Convert RmlUI vertices to our format
-    std::vector<UIVertex> uiVertices(num_vertices);
-    for (int i = 0; i < num_vertices; ++i) {
-        const Rml::Vertex& rmlVertex = vertices[i];
-        UIVertex& uiVertex = uiVertices[i];
-        
-        uiVertex.position = glm::vec2(rmlVertex.position.x, rmlVertex.position.y);
-        uiVertex.color = glm::vec4(
-            rmlVertex.colour.red / 255.0f,
-            rmlVertex.colour.green / 255.0f,
-            rmlVertex.colour.blue / 255.0f,
-            rmlVertex.colour.alpha / 255.0f
-        );
-        uiVertex.texCoord = glm::vec2(rmlVertex.tex_coord.x, rmlVertex.tex_coord.y);
-    }
-
-    // Copy to buffer
-    void* data = m_resourceManager->MapBuffer(m_vertexBuffer);
-    if (data) {
-        memcpy(data, uiVertices.data(), sizeof(UIVertex) * num_vertices);
-        m_resourceManager->FlushBuffer(m_vertexBuffer, 0, sizeof(UIVertex) * num_vertices);
-        m_resourceManager->UnmapBuffer(m_vertexBuffer);
-    }
-}
-
-void VulkanRmlRenderer::UpdateIndexBuffer(int* indices, int num_indices) {
-    if (!m_indexBuffer.IsValid() || num_indices == 0) {
-        return;
-    }
-
-    // Copy indices to buffer
-    void* data = m_resourceManager->MapBuffer(m_indexBuffer);
-    if (data) {
-        memcpy(data, indices, sizeof(uint32_t) * num_indices);
-        m_resourceManager->FlushBuffer(m_indexBuffer, 0, sizeof(uint32_t) * num_indices);
-        m_resourceManager->UnmapBuffer(m_indexBuffer);
-    }
-}
-
 VulkanRmlRenderer::TextureResource* VulkanRmlRenderer::CreateTextureFromData(const Rml::byte* data, int width, int height, int channels) {
     if (!data || width <= 0 || height <= 0) {
         return nullptr;
     }
 
+    // Small RGBA images share atlas pages; anything the atlas cannot take gets its own image
+    if (channels == 4 && width <= static_cast<int>(ATLAS_MAX_TEXTURE_SIZE) && height <= static_cast<int>(ATLAS_MAX_TEXTURE_SIZE)) {
+        if (TextureResource* texture = CreateAtlasTexture(data, width, height)) {
+            return texture;
+        }
+    }
+
     // Create staging buffer
     VkDeviceSize imageSize = width * height * channels;
     AllocatedBuffer stagingBuffer = m_resourceManager->CreateStagingBuffer(imageSize);
@@ -643,30 +1247,190 @@ VulkanRmlRenderer::TextureResource* VulkanRmlRenderer::CreateTextureFromData(con
         return nullptr;
     }
 
-    // Transition image layout and copy data
-    m_resourceManager->TransitionImageLayout(image.image, format,
-                                           VK_IMAGE_LAYOUT_UNDEFINED,
-                                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    auto texture = std::make_unique<TextureResource>();
+    texture->image = image;
+    texture->sampler = m_defaultSampler; // Use shared sampler
+    texture->width = width;
+    texture->height = height;
+
+    if (!RegisterTexture(texture.get())) {
+        m_resourceManager->DestroyImage(image);
+        m_resourceManager->DestroyBuffer(stagingBuffer);
+        return nullptr;
+    }
+
+    // Record into this frame's upload batch; EndFrame submits it
+    if (!BeginTextureUpload()) {
+        DestroyTexture(texture.get());
+        m_resourceManager->DestroyBuffer(stagingBuffer);
+        return nullptr;
+    }
+
+    m_pendingUpload.batch->TransitionImageLayout(image.image, format,
+                                                 VK_IMAGE_LAYOUT_UNDEFINED,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-    m_resourceManager->CopyBufferToImage(stagingBuffer, image, width, height);
+    m_pendingUpload.batch->CopyBufferToImage(stagingBuffer, image, width, height);
 
-    m_resourceManager->TransitionImageLayout(image.image, format,
-                                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    m_pendingUpload.batch->TransitionImageLayout(image.image, format,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // Staging buffer lives until the batch completes
+    m_pendingUpload.stagingBuffers.push_back(stagingBuffer);
+
+    return texture.release();
+}
 
-    // Cleanup staging buffer
-    m_resourceManager->DestroyBuffer(stagingBuffer);
+VulkanRmlRenderer::TextureResource* VulkanRmlRenderer::CreateAtlasTexture(const Rml::byte* data, int width, int height) {
+    // First page with room, or a new one
+    AtlasPage* page = nullptr;
+    AtlasRect rect;
+    for (auto& candidate : m_atlasPages) {
+        if (candidate->atlas.Allocate(width, height, rect)) {
+            page = candidate.get();
+            break;
+        }
+    }
+    if (!page) {
+        page = CreateAtlasPage();
+        if (!page || !page->atlas.Allocate(width, height, rect)) {
+            return nullptr;
+        }
+    }
+
+    AllocatedBuffer stagingBuffer = m_resourceManager->CreateStagingBuffer(VkDeviceSize(rect.width) * rect.height * 4);
+    if (!stagingBuffer.IsValid() || !BeginTextureUpload()) {
+        if (stagingBuffer.IsValid()) {
+            m_resourceManager->DestroyBuffer(stagingBuffer);
+        }
+        page->atlas.Free(rect);
+        return nullptr;
+    }
+
+    // The padding repeats the edge pixels, so filtering at the border never reaches a neighbour
+    const int padding = static_cast<int>(page->atlas.GetPadding());
+    Rml::byte* stagingData = static_cast<Rml::byte*>(m_resourceManager->MapBuffer(stagingBuffer));
+    if (stagingData) {
+        for (uint32_t y = 0; y < rect.height; ++y) {
+            int sourceY = std::clamp(static_cast<int>(y) - padding, 0, height - 1);
+            const Rml::byte* sourceRow = data + static_cast<size_t>(sourceY) * width * 4;
+            Rml::byte* destinationRow = stagingData + static_cast<size_t>(y) * rect.width * 4;
+
+            for (int x = 0; x < padding; ++x) {
+                memcpy(destinationRow + x * 4, sourceRow, 4);
+                memcpy(destinationRow + (padding + width + x) * 4, sourceRow + (width - 1) * 4, 4);
+            }
+            memcpy(destinationRow + padding * 4, sourceRow, static_cast<size_t>(width) * 4);
+        }
+        m_resourceManager->UnmapBuffer(stagingBuffer);
+    }
+
+    // The page stays in TRANSFER_DST for the rest of this batch; FlushTextureUploads restores it
+    if (!page->inUploadBatch) {
+        m_pendingUpload.batch->TransitionImageLayout(page->texture->image.image, page->texture->image.format,
+                                                     page->layout,
+                                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        page->inUploadBatch = true;
+    }
+
+    m_pendingUpload.batch->CopyBufferToImageRegion(stagingBuffer, page->texture->image,
+                                                   {static_cast<int32_t>(rect.x), static_cast<int32_t>(rect.y)},
+                                                   rect.width, rect.height);
+    m_pendingUpload.stagingBuffers.push_back(stagingBuffer);
 
-    // Create texture resource
     auto texture = std::make_unique<TextureResource>();
-    texture->image = image;
-    texture->sampler = m_defaultSampler; // Use shared sampler
+    texture->sampler = m_defaultSampler;
     texture->width = width;
     texture->height = height;
+    texture->textureIndex = page->texture->textureIndex;
+    texture->descriptorSet = page->texture->descriptorSet;
+    texture->atlasPage = page;
+    texture->atlasRect = rect;
+
+    const float pageSize = static_cast<float>(ATLAS_PAGE_SIZE);
+    texture->uvRect = glm::vec4((rect.x + padding) / pageSize, (rect.y + padding) / pageSize,
+                                width / pageSize, height / pageSize);
 
     return texture.release();
 }
 
+VulkanRmlRenderer::AtlasPage* VulkanRmlRenderer::CreateAtlasPage() {
+    AllocatedImage image = m_resourceManager->CreateTexture2D(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, VK_FORMAT_R8G8B8A8_UNORM);
+    if (!image.IsValid()) {
+        return nullptr;
+    }
+
+    auto page = std::make_unique<AtlasPage>(ATLAS_PAGE_SIZE, ATLAS_PADDING);
+    page->texture = std::make_unique<TextureResource>();
+    page->texture->image = image;
+    page->texture->sampler = m_defaultSampler;
+    page->texture->width = ATLAS_PAGE_SIZE;
+    page->texture->height = ATLAS_PAGE_SIZE;
+
+    if (!RegisterTexture(page->texture.get())) {
+        m_resourceManager->DestroyImage(image);
+        return nullptr;
+    }
+
+    m_atlasPages.push_back(std::move(page));
+    return m_atlasPages.back().get();
+}
+
+bool VulkanRmlRenderer::BeginTextureUpload() {
+    if (!m_pendingUpload.batch) {
+        m_pendingUpload.batch = m_resourceManager->BeginUploadBatch();
+    }
+    return m_pendingUpload.batch != nullptr;
+}
+
+const VulkanRmlRenderer::TextureResource* VulkanRmlRenderer::ResolveTexture(Rml::TextureHandle texture) const {
+    auto it = m_textures.find(texture);
+    return it != m_textures.end() ? it->second.get() : m_defaultTexture;
+}
+
+void VulkanRmlRenderer::FreeGeometry(Rml::CompiledGeometryHandle geometry) {
+    auto it = m_geometries.find(geometry);
+    if (it != m_geometries.end()) {
+        // Returned to the heap once frames in flight are done with it
+        m_geometryHeap.Free(it->second->allocation);
+        
+        // Remove from map
+        m_geometries.erase(it);
+    }
+}
+
+void VulkanRmlRenderer::FreeTexture(Rml::TextureHandle texture) {
+    auto it = m_textures.find(texture);
+    if (it != m_textures.end()) {
+        // Submit a pending upload of the image now, so the frame that retires it also covers
+        // the copy. Atlas pages outlive their entries, so those need not.
+        if (!it->second->atlasPage && m_pendingUpload.batch) {
+            FlushTextureUploads();
+        }
+
+        // Frames in flight may still sample it
+        TextureResource* retired = it->second.release();
+        m_textures.erase(it);
+        m_resourceManager->Retire([this, retired]() {
+            DestroyTexture(retired);
+            delete retired;
+        });
+    }
+}
+
+void VulkanRmlRenderer::FreeDeferredReleases() {
+    for (Rml::CompiledGeometryHandle geometry : m_deferredGeometryReleases) {
+        FreeGeometry(geometry);
+    }
+    m_deferredGeometryReleases.clear();
+
+    for (Rml::TextureHandle texture : m_deferredTextureReleases) {
+        FreeTexture(texture);
+    }
+    m_deferredTextureReleases.clear();
+}
+
 VulkanRmlRenderer::TextureResource* VulkanRmlRenderer::LoadTextureFromFile(const std::string& path) {
     int width, height, channels;
     stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
@@ -682,33 +1446,411 @@ VulkanRmlRenderer::TextureResource* VulkanRmlRenderer::LoadTextureFromFile(const
     return texture;
 }
 
-void VulkanRmlRenderer::BindPipeline() {
-    if (m_pipeline != VK_NULL_HANDLE && m_currentCommandBuffer) {
-        vkCmdBindPipeline(m_currentCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
-        
-        // Bind vertex buffer
-        VkBuffer vertexBuffers[] = {m_vertexBuffer.buffer};
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(m_currentCommandBuffer, 0, 1, vertexBuffers, offsets);
-        
-        // Bind index buffer
-        vkCmdBindIndexBuffer(m_currentCommandBuffer, m_indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+bool VulkanRmlRenderer::RegisterTexture(TextureResource* texture) {
+    VkDevice device = m_renderer->GetDevice();
+
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = texture->image.imageView;
+    imageInfo.sampler = texture->sampler;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+
+    if (m_bindless) {
+        if (m_freeTextureSlots.empty()) {
+            std::cerr << "Bindless texture array is full (" << BINDLESS_TEXTURE_CAPACITY << " textures)" << std::endl;
+            return false;
+        }
+        texture->textureIndex = m_freeTextureSlots.back();
+        m_freeTextureSlots.pop_back();
+
+        write.dstSet = m_descriptorSet;
+        write.dstBinding = 1;
+        write.dstArrayElement = texture->textureIndex;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    } else {
+        VkDescriptorSetAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_descriptorSetLayout;
+
+        if (vkAllocateDescriptorSets(device, &allocInfo, &texture->descriptorSet) != VK_SUCCESS) {
+            std::cerr << "Failed to allocate texture descriptor set" << std::endl;
+            return false;
+        }
+
+        write.dstSet = texture->descriptorSet;
+        write.dstBinding = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     }
+
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    return true;
 }
 
-void VulkanRmlRenderer::UpdateDescriptorSet(Rml::TextureHandle texture) {
-    // TODO: Implement descriptor set updates for textures
-    // This is a placeholder implementation
+void VulkanRmlRenderer::DestroyTexture(TextureResource* texture) {
+    // Atlas entries own nothing but their region
+    if (texture->atlasPage) {
+        texture->atlasPage->atlas.Free(texture->atlasRect);
+        return;
+    }
+
+    VkDevice device = m_renderer->GetDevice();
+
+    // The sampler is normally the shared default one
+    if (texture->sampler != VK_NULL_HANDLE && texture->sampler != m_defaultSampler) {
+        vkDestroySampler(device, texture->sampler, nullptr);
+    }
+
+    if (m_bindless) {
+        // Partially bound: the stale slot is never read until it is written again
+        m_freeTextureSlots.push_back(texture->textureIndex);
+    } else if (texture->descriptorSet != VK_NULL_HANDLE) {
+        vkFreeDescriptorSets(device, m_descriptorPool, 1, &texture->descriptorSet);
+        texture->descriptorSet = VK_NULL_HANDLE;
+    }
+
+    m_resourceManager->DestroyImage(texture->image);
 }
 
-void VulkanRmlRenderer::DrawGeometry(int num_indices) {
-    if (m_currentCommandBuffer && num_indices > 0) {
-        // Apply scissor if enabled
-        if (m_scissorEnabled) {
-            vkCmdSetScissor(m_currentCommandBuffer, 0, 1, &m_scissorRect);
+void VulkanRmlRenderer::FlushTextureUploads() {
+    RetireTextureUploads(false);
+
+    if (!m_pendingUpload.batch) {
+        return;
+    }
+
+    // Atlas pages written in this batch go back to being sampled
+    for (auto& page : m_atlasPages) {
+        if (page->inUploadBatch) {
+            m_pendingUpload.batch->TransitionImageLayout(page->texture->image.image, page->texture->image.format,
+                                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
         }
-        
-        // Draw indexed
-        vkCmdDrawIndexed(m_currentCommandBuffer, num_indices, 1, 0, 0, 0);
     }
-}
\ No newline at end of file
+
+    bool submitted = m_pendingUpload.batch->Submit();
+    for (auto& page : m_atlasPages) {
+        // A batch that failed to submit never ran, so the page keeps its old layout
+        if (page->inUploadBatch && submitted) {
+            page->layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+        page->inUploadBatch = false;
+    }
+
+    if (submitted) {
+        m_inFlightUploads.push_back(std::move(m_pendingUpload));
+    } else {
+        m_pendingUpload.batch.reset();
+        for (const AllocatedBuffer& stagingBuffer : m_pendingUpload.stagingBuffers) {
+            m_resourceManager->DestroyBuffer(stagingBuffer);
+        }
+    }
+
+    m_pendingUpload = TextureUpload{};
+}
+
+void VulkanRmlRenderer::RetireTextureUploads(bool wait) {
+    auto it = m_inFlightUploads.begin();
+    while (it != m_inFlightUploads.end()) {
+        if (wait) {
+            it->batch->Wait();
+        } else if (!it->batch->IsComplete()) {
+            ++it;
+            continue;
+        }
+
+        for (const AllocatedBuffer& stagingBuffer : it->stagingBuffers) {
+            m_resourceManager->DestroyBuffer(stagingBuffer);
+        }
+        it = m_inFlightUploads.erase(it);
+    }
+}
+
+void VulkanRmlRenderer::BindPipeline(VkCommandBuffer commandBuffer, BoundState& state, uint32_t variant) const {
+    // Variants share the pipeline layout, so bound descriptors and push constants carry over
+    VkPipeline pipeline = m_pipelines[variant];
+    if (pipeline != state.pipeline) {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        state.pipeline = pipeline;
+    }
+}
+
+void VulkanRmlRenderer::BindTexture(VkCommandBuffer commandBuffer, BoundState& state, const TextureResource* texture) const {
+    // Bindless: the array is bound once per command buffer and draws pick a slot by push constant
+    VkDescriptorSet descriptorSet = m_bindless ? m_descriptorSet : (texture ? texture->descriptorSet : VK_NULL_HANDLE);
+    if (m_pipelineLayout == VK_NULL_HANDLE || descriptorSet == VK_NULL_HANDLE ||
+        descriptorSet == state.descriptorSet) {
+        return;
+    }
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout,
+                            0, 1, &descriptorSet, 0, nullptr);
+    state.descriptorSet = descriptorSet;
+}
+
+VkRect2D VulkanRmlRenderer::ComputeDrawBounds(const CompiledGeometry& geometry, glm::vec2 translation) const {
+    VkRect2D scissor = m_scissorEnabled ? m_scissorRect : VkRect2D{{0, 0}, {m_framebufferWidth, m_framebufferHeight}};
+
+    // Same transform as ui.vert, then NDC to framebuffer pixels
+    glm::vec2 pixelMin(std::numeric_limits<float>::max());
+    glm::vec2 pixelMax(std::numeric_limits<float>::lowest());
+    const glm::vec2 corners[4] = {
+        geometry.boundsMin, {geometry.boundsMax.x, geometry.boundsMin.y},
+        {geometry.boundsMin.x, geometry.boundsMax.y}, geometry.boundsMax
+    };
+    for (const glm::vec2& corner : corners) {
+        glm::vec4 clip = m_currentTransform * glm::vec4(corner + translation, 0.0f, 1.0f);
+
+        // Behind the eye under a perspective transform: the projection is unbounded
+        if (clip.w <= 1e-6f) {
+            return scissor;
+        }
+
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        glm::vec2 pixel((ndc.x * 0.5f + 0.5f) * m_framebufferWidth, (ndc.y * 0.5f + 0.5f) * m_framebufferHeight);
+        pixelMin = glm::min(pixelMin, pixel);
+        pixelMax = glm::max(pixelMax, pixel);
+    }
+
+    // One pixel of slack for rasterization rounding and antialiased edges
+    glm::vec2 limit(static_cast<float>(m_framebufferWidth), static_cast<float>(m_framebufferHeight));
+    pixelMin = glm::clamp(glm::floor(pixelMin) - 1.0f, glm::vec2(0.0f), limit);
+    pixelMax = glm::clamp(glm::ceil(pixelMax) + 1.0f, glm::vec2(0.0f), limit);
+
+    VkRect2D bounds = {};
+    bounds.offset = {static_cast<int32_t>(pixelMin.x), static_cast<int32_t>(pixelMin.y)};
+    bounds.extent = {static_cast<uint32_t>(pixelMax.x - pixelMin.x), static_cast<uint32_t>(pixelMax.y - pixelMin.y)};
+
+    VkRect2D visible = {};
+    IntersectRect(bounds, scissor, visible);
+    return visible;
+}
+
+void VulkanRmlRenderer::RenderDamage(const std::vector<VkRect2D>& damage) {
+    VkCommandBuffer commandBuffer = m_currentCommandBuffer;
+
+    // Earlier frames left the target shader-readable; a new one has no contents to keep
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = (m_target.layout == VK_IMAGE_LAYOUT_UNDEFINED) ? 0 : VK_ACCESS_SHADER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.oldLayout = m_target.layout;
+    barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_target.image.image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    VkPipelineStageFlags srcStage = (m_target.layout == VK_IMAGE_LAYOUT_UNDEFINED) ?
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    // The render area only needs to cover the damage; the rest is loaded and stored untouched
+    VkRect2D renderArea = damage[0];
+    for (const VkRect2D& rect : damage) {
+        renderArea = UnionRect(renderArea, rect);
+    }
+
+    // Each layer is a contiguous run of batches; layers are kept apart so they can be recorded apart
+    const std::vector<UIDrawBatch>& batches = m_drawRecorder.Build();
+    std::vector<LayerRange> layers;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        if (layers.empty() || batches[i].layer != batches[layers.back().begin].layer) {
+            layers.push_back({i, i});
+        }
+        layers.back().end = i + 1;
+    }
+
+    // A single layer gains nothing from a secondary command buffer and is recorded inline
+    std::vector<VkCommandBuffer> layerCommandBuffers;
+    if (layers.size() > 1) {
+        layerCommandBuffers = RecordLayers(damage, batches, layers);
+    }
+
+    VkRenderPassBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    beginInfo.renderPass = m_targetRenderPass;
+    beginInfo.framebuffer = m_target.framebuffer;
+    beginInfo.renderArea = renderArea;
+
+    if (!layerCommandBuffers.empty()) {
+        vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(layerCommandBuffers.size()),
+                             layerCommandBuffers.data());
+    } else {
+        vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        ReplayDraws(commandBuffer, damage, batches, {0, batches.size()}, true);
+    }
+
+    vkCmdEndRenderPass(commandBuffer);
+    m_target.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+}
+
+std::vector<VkCommandBuffer> VulkanRmlRenderer::RecordLayers(const std::vector<VkRect2D>& damage,
+                                                             const std::vector<UIDrawBatch>& batches,
+                                                             const std::vector<LayerRange>& layers) const {
+    VulkanCommandBuffer* commandBuffers = m_renderer->GetCommandBuffer();
+    if (!commandBuffers) {
+        return {};
+    }
+
+    VkCommandBufferInheritanceInfo inheritance = {};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = m_targetRenderPass;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = m_target.framebuffer;
+
+    // Every thread allocates from its own pool in the frame slot, so layers record without locking
+    std::vector<VkCommandBuffer> recorded(layers.size(), VK_NULL_HANDLE);
+    auto recordLayer = [&](size_t index) {
+        try {
+            VkCommandBuffer commandBuffer = commandBuffers->AllocateFrameCommandBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+            VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                                              VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            if (!commandBuffers->BeginRecording(commandBuffer, usage, &inheritance)) {
+                return;
+            }
+
+            // No commands may sit inline between the secondaries, so the first layer does the clear
+            ReplayDraws(commandBuffer, damage, batches, layers[index], index == 0);
+
+            if (commandBuffers->EndRecording(commandBuffer)) {
+                recorded[index] = commandBuffer;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to record UI layer " << index << ": " << e.what() << std::endl;
+        }
+    };
+
+    if (m_jobSystem && m_jobSystem->GetWorkerCount() > 0) {
+        JobHandle handle = m_jobSystem->ParallelFor(0, layers.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                recordLayer(i);
+            }
+        });
+        m_jobSystem->Wait(handle);
+    } else {
+        for (size_t i = 0; i < layers.size(); ++i) {
+            recordLayer(i);
+        }
+    }
+
+    // Layers depend on each other's blending, so a missing one means recording them all inline
+    for (VkCommandBuffer commandBuffer : recorded) {
+        if (commandBuffer == VK_NULL_HANDLE) {
+            std::cerr << "UI layers fall back to inline recording" << std::endl;
+            return {};
+        }
+    }
+    return recorded;
+}
+
+void VulkanRmlRenderer::ReplayDraws(VkCommandBuffer commandBuffer, const std::vector<VkRect2D>& damage,
+                                    const std::vector<UIDrawBatch>& batches, LayerRange range, bool clear) const {
+    // Dynamic state is not inherited, so every command buffer sets its own
+    VkViewport viewport = {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(m_framebufferWidth);
+    viewport.height = static_cast<float>(m_framebufferHeight);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    // Damaged regions are cleared and every draw touching them is replayed, clipped to them
+    if (clear) {
+        VkClearAttachment clearAttachment = {};
+        clearAttachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        clearAttachment.colorAttachment = 0;
+        clearAttachment.clearValue.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+
+        std::vector<VkClearRect> clearRects;
+        clearRects.reserve(damage.size());
+        for (const VkRect2D& rect : damage) {
+            clearRects.push_back({rect, 0, 1});
+        }
+        vkCmdClearAttachments(commandBuffer, 1, &clearAttachment,
+                              static_cast<uint32_t>(clearRects.size()), clearRects.data());
+    }
+
+    // Nothing is bound on the command buffer yet
+    BoundState state;
+
+    // Damage rectangles are disjoint, so replaying the range once per rectangle blends no pixel twice
+    for (const VkRect2D& clipRect : damage) {
+        for (size_t i = range.begin; i < range.end; ++i) {
+            const UIDrawBatch& batch = batches[i];
+            VkRect2D visible = {};
+            VkRect2D scissor = {};
+            if (!IntersectRect(batch.bounds, clipRect, visible) ||
+                !IntersectRect(batch.scissor, clipRect, scissor)) {
+                continue;
+            }
+
+            uint32_t variant = (batch.texture != 0) ? PIPELINE_VARIANT_TEXTURED : 0;
+            if (m_pipelines[variant] == VK_NULL_HANDLE) {
+                continue;
+            }
+            BindPipeline(commandBuffer, state, variant);
+
+            if (scissor.offset.x != state.scissor.offset.x ||
+                scissor.offset.y != state.scissor.offset.y ||
+                scissor.extent.width != state.scissor.extent.width ||
+                scissor.extent.height != state.scissor.extent.height) {
+                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+                state.scissor = scissor;
+            }
+
+            // Atlas entries resolve to their page, so switching between them binds nothing
+            const TextureResource* texture = ResolveTexture(batch.texture);
+            BindTexture(commandBuffer, state, texture);
+
+            // Geometry in the same heap buffer is reached through vertexOffset instead of a rebind,
+            // as long as it sits a whole number of vertices from the bound offset
+            VkDeviceSize vertexDelta = batch.vertexOffset - state.vertexBufferOffset;
+            if (batch.buffer != state.vertexBuffer ||
+                batch.vertexOffset < state.vertexBufferOffset ||
+                vertexDelta % sizeof(Rml::Vertex) != 0 ||
+                vertexDelta / sizeof(Rml::Vertex) > static_cast<VkDeviceSize>(INT32_MAX)) {
+                vkCmdBindVertexBuffers(commandBuffer, 0, 1, &batch.buffer, &batch.vertexOffset);
+                state.vertexBuffer = batch.buffer;
+                state.vertexBufferOffset = batch.vertexOffset;
+                vertexDelta = 0;
+            }
+
+            // Index data is always 4-byte aligned, so one bind per buffer covers every draw
+            if (batch.buffer != state.indexBuffer) {
+                vkCmdBindIndexBuffer(commandBuffer, batch.buffer, 0, VK_INDEX_TYPE_UINT32);
+                state.indexBuffer = batch.buffer;
+            }
+
+            UIPushConstants pushConstants = {};
+            pushConstants.transform = m_drawRecorder.GetTransform(batch.transform);
+            pushConstants.translation = batch.translation;
+            pushConstants.textureIndex = texture ? texture->textureIndex : 0;
+            pushConstants.uvRect = batch.uvRect;
+
+            if (m_pipelineLayout != VK_NULL_HANDLE &&
+                (!state.pushConstantsValid ||
+                 memcmp(&pushConstants, &state.pushConstants, sizeof(UIPushConstants)) != 0)) {
+                vkCmdPushConstants(commandBuffer, m_pipelineLayout,
+                                   VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                   0, sizeof(UIPushConstants), &pushConstants);
+                state.pushConstants = pushConstants;
+                state.pushConstantsValid = true;
+            }
+
+            vkCmdDrawIndexed(commandBuffer, batch.indexCount, 1,
+                             static_cast<uint32_t>(batch.indexOffset / sizeof(uint32_t)),
+                             static_cast<int32_t>(vertexDelta / sizeof(Rml::Vertex)), 0);
+        }
+    }
+}
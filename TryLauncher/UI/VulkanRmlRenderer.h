@@ -1,6 +1,7 @@
 #pragma once
 
 #include <RmlUi/Core/RenderInterface.h>
+#include <RmlUi/Core/Vertex.h>
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 #include <glm/glm.hpp>
@@ -8,32 +9,55 @@
 #include <vector>
 #include <unordered_map>
 #include <array>
+#include <memory>
 #include "../Vulkan/ResourceManager.h"
+#include "../Vulkan/VulkanSwapchain.h"
+#include "UIGeometryHeap.h"
+#include "UIDrawRecorder.h"
+#include "UITextureAtlas.h"
+#include "UIDamageTracker.h"
 
 // Forward declarations
 class VulkanRenderer;
+class JobSystem;
 
 /**
  * VulkanRmlRenderer implements RmlUI's RenderInterface for Vulkan backend.
  * This class handles:
- * - UI geometry rendering with vertex/index buffers
- * - Texture loading and management for UI elements
+ * - UI geometry rendering, with consecutive compatible draws merged into one
+ * - Rendering into a persistent offscreen target, redrawing only the regions that changed
+ *   since the previous frame, and compositing that target over the frame
+ * - Recording each UI layer into a secondary command buffer of its own, in parallel on the JobSystem
+ * - Texture loading and management for UI elements, uploaded in one batch per frame
+ * - Packing small textures into shared atlas pages; larger ones get their own image
+ * - Bindless texturing through one descriptor array when descriptor indexing is available,
+ *   with a descriptor set per texture as the fallback
  * - Transform and scissor region management
- * - UI-specific Vulkan pipeline and descriptor sets
+ * - UI-specific Vulkan pipelines, built from embedded SPIR-V with one specialized variant
+ *   per draw kind, and descriptor sets
  */
 class VulkanRmlRenderer : public Rml::RenderInterface {
 public:
-    VulkanRmlRenderer(VulkanRenderer* renderer, ResourceManager* resourceManager);
+    VulkanRmlRenderer(VulkanRenderer* renderer, ResourceManager* resourceManager, JobSystem* jobSystem = nullptr);
     ~VulkanRmlRenderer();
 
     // Initialization and cleanup
     bool Initialize();
     void Cleanup();
 
-    // Frame management
-    void BeginFrame(VkCommandBuffer commandBuffer, VkRenderPass renderPass, 
-                   uint32_t framebufferWidth, uint32_t framebufferHeight);
+    // Frame management. BeginFrame/EndFrame record the UI into the offscreen target and must
+    // be called outside a render pass; Composite then draws the target inside one.
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t framebufferWidth, uint32_t framebufferHeight);
     void EndFrame();
+    // Draws after this belong to the next layer, drawn over the earlier ones, e.g. one per Rml::Context
+    void BeginLayer() { m_drawRecorder.BeginLayer(); }
+    void Composite(VkCommandBuffer commandBuffer, VkRenderPass renderPass,
+                   uint32_t framebufferWidth, uint32_t framebufferHeight);
+
+    // Regions redrawn by the last EndFrame, in framebuffer pixels; empty when nothing changed
+    const std::vector<VkRect2D>& GetDamage() const { return m_damageTracker.GetDamage(); }
+    // The next frame redraws the whole target
+    void InvalidateAll() { m_damageTracker.InvalidateAll(); }
 
     // RenderInterface implementation
     Rml::CompiledGeometryHandle CompileGeometry(Rml::Span<const Rml::Vertex> vertices, Rml::Span<const int> indices) override;
@@ -51,30 +75,46 @@ public:
     void SetTransform(const Rml::Matrix4f* transform) override;
 
 private:
-    // Compiled geometry structure
+    // Compiled geometry: vertices followed by indices in one heap allocation
     struct CompiledGeometry {
-        AllocatedBuffer vertexBuffer;
-        AllocatedBuffer indexBuffer;
-        uint32_t indexCount;
-        uint32_t vertexCount;
-    };
+        GeometryAllocation allocation;
+        VkDeviceSize indexOffset = 0;   // From the start of the allocation
+        uint32_t indexCount = 0;
+        uint32_t vertexCount = 0;
+        glm::vec2 boundsMin = glm::vec2(0.0f);  // Extent of the vertices, before translation
+        glm::vec2 boundsMax = glm::vec2(0.0f);
 
-    // Vertex structure for UI rendering
-    struct UIVertex {
-        glm::vec2 position;
-        glm::vec4 color;
-        glm::vec2 texCoord;
-        
-        static VkVertexInputBindingDescription GetBindingDescription();
-        static std::array<VkVertexInputAttributeDescription, 3> GetAttributeDescriptions();
+        // CPU copy of small geometry so UIDrawRecorder can merge it; empty otherwise
+        std::vector<Rml::Vertex> vertices;
+        std::vector<int> indices;
     };
 
+    // The UI pipeline reads Rml::Vertex as is: float2 position, RGBA8 colour (UNORM),
+    // float2 texcoord, 20-byte stride. Geometry is copied without conversion.
+    static VkVertexInputBindingDescription GetVertexBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 3> GetVertexAttributeDescriptions();
+
     // Push constants for UI rendering
     struct UIPushConstants {
         glm::mat4 transform;
         glm::vec2 translation;
-        int useTexture;
-        float _padding;
+        uint32_t textureIndex;  // Slot in the bindless texture array
+        uint32_t padding;       // uvRect sits on a 16-byte boundary in the shaders
+        glm::vec4 uvRect;       // Atlas sub-rectangle: offset in xy, scale in zw
+    };
+
+    // Pipeline variants: each bit is a specialization constant in the shaders
+    static constexpr uint32_t PIPELINE_VARIANT_TEXTURED = 1u << 0;    // constant_id 0
+    static constexpr uint32_t PIPELINE_VARIANT_COUNT = 2;
+
+    struct AtlasPage;
+
+    // The image the UI is drawn into. Pixels outside the damage carry over from earlier frames.
+    struct RenderTarget {
+        AllocatedImage image;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        VkDescriptorSet compositeSet = VK_NULL_HANDLE;  // Samples image in the composite pass
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
     };
 
     // Texture resource wrapper
@@ -83,55 +123,155 @@ private:
         VkSampler sampler = VK_NULL_HANDLE;
         uint32_t width = 0;
         uint32_t height = 0;
+        uint32_t textureIndex = 0;                      // Bindless mode
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE; // Fallback mode
+
+        // Atlas entries share the page's image and descriptors; image stays empty
+        AtlasPage* atlasPage = nullptr;
+        AtlasRect atlasRect;
+        glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    };
+
+    // One shared image that small textures are packed into
+    struct AtlasPage {
+        std::unique_ptr<TextureResource> texture;
+        UITextureAtlas atlas;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        bool inUploadBatch = false;     // Left in TRANSFER_DST until the pending batch is submitted
+
+        explicit AtlasPage(uint32_t size, uint32_t padding) : atlas(size, size, padding) {}
     };
 
     // Initialization helpers
     bool CreatePipeline();
+    bool CreatePipelineVariants(VkRenderPass renderPass);
+    void RetirePipelineVariants();
+    bool CreateTargetRenderPass();
+    bool CreateCompositeResources();
+    bool CreateCompositePipeline(VkRenderPass renderPass);
+    bool CreateRenderTarget(uint32_t width, uint32_t height);
+    void RetireRenderTarget();
+    VkShaderModule CreateShaderModule(const uint32_t* code, size_t size);
     bool CreateDescriptorSetLayout();
     bool CreateDescriptorPool();
     bool CreateSampler();
     bool CreateDefaultTexture();
+    bool CreateBindlessDescriptorSet();
 
     // Resource management
-    void UpdateVertexBuffer(Rml::Vertex* vertices, int num_vertices);
-    void UpdateIndexBuffer(int* indices, int num_indices);
     TextureResource* CreateTextureFromData(const Rml::byte* data, int width, int height, int channels);
     TextureResource* LoadTextureFromFile(const std::string& path);
+    TextureResource* CreateAtlasTexture(const Rml::byte* data, int width, int height);
+    AtlasPage* CreateAtlasPage();
+    bool BeginTextureUpload();
+    const TextureResource* ResolveTexture(Rml::TextureHandle texture) const;
+    void FreeGeometry(Rml::CompiledGeometryHandle geometry);
+    void FreeTexture(Rml::TextureHandle texture);
+    void FreeDeferredReleases();
+    bool RegisterTexture(TextureResource* texture);
+    void DestroyTexture(TextureResource* texture);
+    void FlushTextureUploads();
+    void RetireTextureUploads(bool wait);
+
+    // State last set on a command buffer, so replaying draws can skip redundant commands
+    struct BoundState {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;
+        VkDeviceSize vertexBufferOffset = 0;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        VkRect2D scissor = {};
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        UIPushConstants pushConstants = {};
+        bool pushConstantsValid = false;
+    };
 
-    // Rendering helpers
-    void BindPipeline();
-    void UpdateDescriptorSet(Rml::TextureHandle texture);
-    void DrawGeometry(int num_indices);
+    // Built batches [begin, end) of one layer
+    struct LayerRange {
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    // Rendering helpers. Replaying only reads renderer state, so layers can record concurrently.
+    void BindPipeline(VkCommandBuffer commandBuffer, BoundState& state, uint32_t variant) const;
+    void BindTexture(VkCommandBuffer commandBuffer, BoundState& state, const TextureResource* texture) const;
+    VkRect2D ComputeDrawBounds(const CompiledGeometry& geometry, glm::vec2 translation) const;
+    void RenderDamage(const std::vector<VkRect2D>& damage);
+    std::vector<VkCommandBuffer> RecordLayers(const std::vector<VkRect2D>& damage,
+                                              const std::vector<UIDrawBatch>& batches,
+                                              const std::vector<LayerRange>& layers) const;
+    void ReplayDraws(VkCommandBuffer commandBuffer, const std::vector<VkRect2D>& damage,
+                     const std::vector<UIDrawBatch>& batches, LayerRange range, bool clear) const;
 
     VulkanRenderer* m_renderer;
     ResourceManager* m_resourceManager;
+    JobSystem* m_jobSystem;
 
     // Vulkan objects
-    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    VkShaderModule m_vertexShader = VK_NULL_HANDLE;
+    VkShaderModule m_fragmentShader = VK_NULL_HANDLE;
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    std::array<VkPipeline, PIPELINE_VARIANT_COUNT> m_pipelines = {};   // Built against m_targetRenderPass
     VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
     VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
-    VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+    VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;   // The bindless texture array
     VkSampler m_defaultSampler = VK_NULL_HANDLE;
 
-    // Buffers
-    AllocatedBuffer m_vertexBuffer;
-    AllocatedBuffer m_indexBuffer;
-    uint32_t m_maxVertices = 10000;
-    uint32_t m_maxIndices = 30000;
+    // Bindless textures: every texture owns a slot in m_descriptorSet, indexed through push constants
+    static constexpr uint32_t BINDLESS_TEXTURE_CAPACITY = 1024;
+    bool m_bindless = false;
+    std::vector<uint32_t> m_freeTextureSlots;
 
     // Textures
     std::unordered_map<Rml::TextureHandle, std::unique_ptr<TextureResource>> m_textures;
     Rml::TextureHandle m_nextTextureHandle = 1;
     TextureResource* m_defaultTexture = nullptr;
 
+    // Atlas pages for textures up to ATLAS_MAX_TEXTURE_SIZE on each side
+    static constexpr uint32_t ATLAS_PAGE_SIZE = 1024;
+    static constexpr uint32_t ATLAS_MAX_TEXTURE_SIZE = 128;
+    static constexpr uint32_t ATLAS_PADDING = 1;
+    std::vector<std::unique_ptr<AtlasPage>> m_atlasPages;
+
+    // Texture uploads recorded since the last EndFrame, submitted together there
+    struct TextureUpload {
+        std::unique_ptr<UploadBatch> batch;
+        std::vector<AllocatedBuffer> stagingBuffers;
+    };
+    TextureUpload m_pendingUpload;
+    std::vector<TextureUpload> m_inFlightUploads;
+
     // Compiled geometry
+    UIGeometryHeap m_geometryHeap;
     std::unordered_map<Rml::CompiledGeometryHandle, std::unique_ptr<CompiledGeometry>> m_geometries;
     Rml::CompiledGeometryHandle m_nextGeometryHandle = 1;
 
+    // Draws recorded since BeginFrame; issued at EndFrame, once the damage is known
+    UIDrawRecorder m_drawRecorder;
+    UIDamageTracker m_damageTracker;
+
+    // Released by RmlUi while draws using them were pending; freed after EndFrame issues them
+    std::vector<Rml::CompiledGeometryHandle> m_deferredGeometryReleases;
+    std::vector<Rml::TextureHandle> m_deferredTextureReleases;
+
+    // Offscreen target, recreated when the framebuffer size changes
+    static constexpr VkFormat TARGET_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+    VkRenderPass m_targetRenderPass = VK_NULL_HANDLE;
+    RenderTarget m_target;
+
+    // Composite pass: one fullscreen triangle sampling the target in the caller's render pass
+    // A resize drag can replace the target every frame, and a retired target's set is only freed
+    // once every frame in flight is done with it; the doubling leaves room for retirement to lag
+    static constexpr uint32_t COMPOSITE_SET_CAPACITY = (VulkanSwapchain::MAX_FRAMES_IN_FLIGHT + 1) * 2;
+    VkShaderModule m_compositeVertexShader = VK_NULL_HANDLE;
+    VkShaderModule m_compositeFragmentShader = VK_NULL_HANDLE;
+    VkDescriptorSetLayout m_compositeSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_compositeDescriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout m_compositePipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_compositePipeline = VK_NULL_HANDLE;
+    VkRenderPass m_compositeRenderPass = VK_NULL_HANDLE;   // The composite pipeline is built against it
+
     // Render state
     VkCommandBuffer m_currentCommandBuffer = VK_NULL_HANDLE;
-    VkRenderPass m_currentRenderPass = VK_NULL_HANDLE;
     uint32_t m_framebufferWidth = 0;
     uint32_t m_framebufferHeight = 0;
 
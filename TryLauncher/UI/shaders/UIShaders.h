@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// SPIR-V of the UI shaders, compiled from the sources next to this file as part of the build
+// (the CustomBuild steps in TryLauncher.vcxproj, or compile_shaders.sh/.bat elsewhere).
+// Embedding them means startup reads no shader files.
+struct UIShaders {
+    static constexpr uint32_t Vertex[] =
+#include "generated/ui.vert.inc"
+    ;
+
+    static constexpr uint32_t Fragment[] =
+#include "generated/ui.frag.inc"
+    ;
+
+    static constexpr uint32_t BindlessFragment[] =
+#include "generated/ui_bindless.frag.inc"
+    ;
+
+    // Draws the offscreen UI target over the frame
+    static constexpr uint32_t CompositeVertex[] =
+#include "generated/ui_composite.vert.inc"
+    ;
+
+    static constexpr uint32_t CompositeFragment[] =
+#include "generated/ui_composite.frag.inc"
+    ;
+};
@@ -1,16 +1,38 @@
 @echo off
+rem The Visual Studio build runs these same steps; this script is for building elsewhere.
+rem Output is SPIR-V as C initializer lists, embedded by UIShaders.h.
 echo Compiling UI shaders...
 
-glslc ui.vert -o ui_vert.spv
+if not exist generated mkdir generated
+
+glslc -mfmt=c ui.vert -o generated\ui.vert.inc
 if %errorlevel% neq 0 (
     echo Failed to compile vertex shader
     exit /b 1
 )
 
-glslc ui.frag -o ui_frag.spv
+glslc -mfmt=c ui.frag -o generated\ui.frag.inc
 if %errorlevel% neq 0 (
     echo Failed to compile fragment shader
     exit /b 1
 )
 
+glslc -mfmt=c ui_bindless.frag -o generated\ui_bindless.frag.inc
+if %errorlevel% neq 0 (
+    echo Failed to compile bindless fragment shader
+    exit /b 1
+)
+
+glslc -mfmt=c ui_composite.vert -o generated\ui_composite.vert.inc
+if %errorlevel% neq 0 (
+    echo Failed to compile composite vertex shader
+    exit /b 1
+)
+
+glslc -mfmt=c ui_composite.frag -o generated\ui_composite.frag.inc
+if %errorlevel% neq 0 (
+    echo Failed to compile composite fragment shader
+    exit /b 1
+)
+
 echo UI shaders compiled successfully
\ No newline at end of file
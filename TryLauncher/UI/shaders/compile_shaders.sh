@@ -1,16 +1,38 @@
 #!/bin/bash
+# The Visual Studio build runs these same steps; this script is for building elsewhere.
+# Output is SPIR-V as C initializer lists, embedded by UIShaders.h.
 echo "Compiling UI shaders..."
 
-glslc ui.vert -o ui_vert.spv
+mkdir -p generated
+
+glslc -mfmt=c ui.vert -o generated/ui.vert.inc
 if [ $? -ne 0 ]; then
     echo "Failed to compile vertex shader"
     exit 1
 fi
 
-glslc ui.frag -o ui_frag.spv
+glslc -mfmt=c ui.frag -o generated/ui.frag.inc
 if [ $? -ne 0 ]; then
     echo "Failed to compile fragment shader"
     exit 1
 fi
 
-echo "UI shaders compiled successfully"
\ No newline at end of file
+glslc -mfmt=c ui_bindless.frag -o generated/ui_bindless.frag.inc
+if [ $? -ne 0 ]; then
+    echo "Failed to compile bindless fragment shader"
+    exit 1
+fi
+
+glslc -mfmt=c ui_composite.vert -o generated/ui_composite.vert.inc
+if [ $? -ne 0 ]; then
+    echo "Failed to compile composite vertex shader"
+    exit 1
+fi
+
+glslc -mfmt=c ui_composite.frag -o generated/ui_composite.frag.inc
+if [ $? -ne 0 ]; then
+    echo "Failed to compile composite fragment shader"
+    exit 1
+fi
+
+echo "UI shaders compiled successfully"
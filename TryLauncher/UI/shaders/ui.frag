@@ -7,7 +7,14 @@ layout(location = 0) out vec4 outColor;
 
 layout(binding = 0) uniform sampler2D texSampler;
 
+// Pipeline variant, see PIPELINE_VARIANT_* in VulkanRmlRenderer.h
+layout(constant_id = 0) const bool TEXTURED = true;
+
 void main() {
-    vec4 texColor = texture(texSampler, fragTexCoord);
-    outColor = fragColor * texColor;
+    // Fixed when the pipeline is created, so this never branches per fragment
+    if (TEXTURED) {
+        outColor = fragColor * texture(texSampler, fragTexCoord);
+    } else {
+        outColor = fragColor;
+    }
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ layout(location = 1) out vec2 fragTexCoord;
 layout(push_constant) uniform PushConstants {
     mat4 transform;
     vec2 translation;
+    uint textureIndex;
+    vec4 uvRect;    // Atlas sub-rectangle: offset in xy, scale in zw
 } pc;
 
 void main() {
@@ -21,5 +23,5 @@ void main() {
     gl_Position = worldPos;
     
     fragColor = inColor;
-    fragTexCoord = inTexCoord;
+    fragTexCoord = pc.uvRect.xy + inTexCoord * pc.uvRect.zw;
 }
\ No newline at end of file
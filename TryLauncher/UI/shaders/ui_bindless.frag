@@ -0,0 +1,30 @@
+#version 450
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+// Must match BINDLESS_TEXTURE_CAPACITY in VulkanRmlRenderer.h
+layout(set = 0, binding = 0) uniform sampler uiSampler;
+layout(set = 0, binding = 1) uniform texture2D uiTextures[1024];
+
+layout(push_constant) uniform PushConstants {
+    mat4 transform;
+    vec2 translation;
+    uint textureIndex;
+    vec4 uvRect;
+} pc;
+
+// Pipeline variant, see PIPELINE_VARIANT_* in VulkanRmlRenderer.h
+layout(constant_id = 0) const bool TEXTURED = true;
+
+void main() {
+    // Fixed when the pipeline is created, so this never branches per fragment
+    if (TEXTURED) {
+        // The index is the same for the whole draw, so no nonuniform qualifier is needed
+        outColor = fragColor * texture(sampler2D(uiTextures[pc.textureIndex], uiSampler), fragTexCoord);
+    } else {
+        outColor = fragColor;
+    }
+}
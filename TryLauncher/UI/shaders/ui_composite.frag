@@ -0,0 +1,12 @@
+#version 450
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+// The UI render target, premultiplied by alpha like the geometry drawn into it
+layout(binding = 0) uniform sampler2D uiTarget;
+
+void main() {
+    outColor = texture(uiTarget, fragTexCoord);
+}
\ No newline at end of file
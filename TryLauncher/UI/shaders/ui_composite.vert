@@ -0,0 +1,10 @@
+#version 450
+
+layout(location = 0) out vec2 fragTexCoord;
+
+void main() {
+    // One triangle covering the screen; no vertex buffer needed
+    vec2 position = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    fragTexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -48,6 +48,10 @@ void ResourceManager::Cleanup() {
         return;
     }
     
+    // Anything still retired was waiting on frames that will never be presented
+    m_renderer->WaitIdle();
+    FlushRetired();
+    
     if (m_allocator != VK_NULL_HANDLE) {
         // Print memory statistics before cleanup
         VmaTotalStatistics stats;
@@ -278,6 +282,104 @@ void ResourceManager::DestroyImage(const AllocatedImage& image) {
     }
 }
 
+void ResourceManager::RetireBuffer(const AllocatedBuffer& buffer) {
+    if (!buffer.IsValid()) {
+        return;
+    }
+    
+    RetiredResource resource;
+    resource.buffer = buffer;
+    PushRetired(std::move(resource));
+}
+
+void ResourceManager::RetireImage(const AllocatedImage& image) {
+    if (!image.IsValid()) {
+        return;
+    }
+    
+    RetiredResource resource;
+    resource.image = image;
+    PushRetired(std::move(resource));
+}
+
+void ResourceManager::RetireSampler(VkSampler sampler) {
+    if (sampler == VK_NULL_HANDLE) {
+        return;
+    }
+    
+    RetiredResource resource;
+    resource.sampler = sampler;
+    PushRetired(std::move(resource));
+}
+
+void ResourceManager::Retire(std::function<void()> destroy) {
+    if (!destroy) {
+        return;
+    }
+    
+    RetiredResource resource;
+    resource.destroy = std::move(destroy);
+    PushRetired(std::move(resource));
+}
+
+void ResourceManager::PushRetired(RetiredResource&& resource) {
+    std::lock_guard<std::mutex> lock(m_retireMutex);
+    m_retired.push_back(std::move(resource));
+}
+
+void ResourceManager::BeginFrame() {
+    VulkanTimeline* timeline = m_renderer->GetVulkanDevice()->GetGraphicsTimeline();
+    uint64_t completed = timeline->GetCompletedValue();
+    
+    {
+        std::lock_guard<std::mutex> lock(m_retireMutex);
+        // Read under the lock: a submission that used a resource retired since is included
+        uint64_t submitted = timeline->GetSubmittedValue();
+        
+        // The frame that retired them, or was still recording when they were retired, has been
+        // submitted by now, so the latest value covers every use. Unset values sit at the back.
+        for (auto it = m_retired.rbegin(); it != m_retired.rend() && it->value == 0; ++it) {
+            it->value = submitted;
+        }
+        
+        while (!m_retired.empty() && m_retired.front().value <= completed) {
+            m_expired.push_back(std::move(m_retired.front()));
+            m_retired.pop_front();
+        }
+    }
+    
+    // Destroy outside the lock; callbacks may retire more resources
+    DestroyRetired(m_expired);
+}
+
+void ResourceManager::FlushRetired() {
+    std::vector<RetiredResource> resources;
+    {
+        std::lock_guard<std::mutex> lock(m_retireMutex);
+        resources.reserve(m_retired.size());
+        for (RetiredResource& resource : m_retired) {
+            resources.push_back(std::move(resource));
+        }
+        m_retired.clear();
+    }
+    
+    DestroyRetired(resources);
+}
+
+void ResourceManager::DestroyRetired(std::vector<RetiredResource>& resources) {
+    for (RetiredResource& resource : resources) {
+        if (resource.destroy) {
+            resource.destroy();
+        }
+        DestroyBuffer(resource.buffer);
+        DestroyImage(resource.image);
+        if (resource.sampler != VK_NULL_HANDLE) {
+            vkDestroySampler(m_renderer->GetDevice(), resource.sampler, nullptr);
+        }
+    }
+    resources.clear();
+}
+
 void* ResourceManager::MapBuffer(const AllocatedBuffer& buffer) {
     if (!m_initialized || !buffer.IsValid()) {
         return nullptr;
@@ -322,6 +424,35 @@ void ResourceManager::InvalidateBuffer(const AllocatedBuffer& buffer, VkDeviceSi
     vmaInvalidateAllocation(m_allocator, buffer.allocation, offset, size);
 }
 
+std::unique_ptr<UploadBatch> ResourceManager::BeginUploadBatch(UploadQueue queue) {
+    if (!m_initialized) {
+        std::cerr << "ResourceManager: Not initialized" << std::endl;
+        return nullptr;
+    }
+    
+    VulkanDevice* device = m_renderer->GetVulkanDevice();
+    const QueueFamilyIndices& families = device->GetQueueFamilyIndices();
+    
+    VulkanTimeline* graphicsTimeline = device->GetGraphicsTimeline();
+    uint32_t graphicsFamily = families.graphicsFamily.value();
+    
+    VulkanTimeline* submitTimeline = graphicsTimeline;
+    uint32_t queueFamily = graphicsFamily;
+    
+    // On a dedicated transfer family the batch hands its results over to graphics itself
+    if (queue == UploadQueue::Transfer) {
+        submitTimeline = device->GetTransferTimeline();
+        queueFamily = families.transferFamily.value();
+    }
+    
+    std::unique_ptr<UploadBatch> batch(new UploadBatch(this, m_renderer->GetDevice(), submitTimeline, queueFamily,
+                                                       graphicsTimeline, graphicsFamily));
+    if (!batch->Begin()) {
+        return nullptr;
+    }
+    return batch;
+}
+
 void ResourceManager::CopyBuffer(const AllocatedBuffer& srcBuffer, 
                                 const AllocatedBuffer& dstBuffer, 
                                 VkDeviceSize size,
@@ -331,16 +462,15 @@ void ResourceManager::CopyBuffer(const AllocatedBuffer& srcBuffer,
         return;
     }
     
-    VkCommandBuffer commandBuffer = m_renderer->BeginSingleTimeCommands();
-    
-    VkBufferCopy copyRegion = {};
-    copyRegion.srcOffset = srcOffset;
-    copyRegion.dstOffset = dstOffset;
-    copyRegion.size = size;
-    
-    vkCmdCopyBuffer(commandBuffer, srcBuffer.buffer, dstBuffer.buffer, 1, &copyRegion);
+    auto batch = BeginUploadBatch();
+    if (!batch) {
+        return;
+    }
     
-    m_renderer->EndSingleTimeCommands(commandBuffer);
+    batch->CopyBuffer(srcBuffer, dstBuffer, size, srcOffset, dstOffset);
+    if (batch->Submit()) {
+        batch->Wait();
+    }
 }
 
 void ResourceManager::CopyBufferToImage(const AllocatedBuffer& buffer,
@@ -352,23 +482,15 @@ void ResourceManager::CopyBufferToImage(const AllocatedBuffer& buffer,
         return;
     }
     
-    VkCommandBuffer commandBuffer = m_renderer->BeginSingleTimeCommands();
-    
-    VkBufferImageCopy region = {};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = layerCount;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
-    
-    vkCmdCopyBufferToImage(commandBuffer, buffer.buffer, image.image, 
-                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    auto batch = BeginUploadBatch();
+    if (!batch) {
+        return;
+    }
     
-    m_renderer->EndSingleTimeCommands(commandBuffer);
+    batch->CopyBufferToImage(buffer, image, width, height, layerCount);
+    if (batch->Submit()) {
+        batch->Wait();
+    }
 }
 
 void ResourceManager::TransitionImageLayout(VkImage image,
@@ -381,9 +503,45 @@ void ResourceManager::TransitionImageLayout(VkImage image,
         return;
     }
     
-    VkCommandBuffer commandBuffer = m_renderer->BeginSingleTimeCommands();
+    auto batch = BeginUploadBatch();
+    if (!batch) {
+        return;
+    }
+    
+    if (batch->TransitionImageLayout(image, format, oldLayout, newLayout, mipLevels, layerCount) && batch->Submit()) {
+        batch->Wait();
+    }
+}
+
+void ResourceManager::GenerateMipmaps(VkImage image,
+                                     VkFormat format,
+                                     uint32_t width,
+                                     uint32_t height,
+                                     uint32_t mipLevels) {
+    if (!m_initialized) {
+        return;
+    }
+    
+    auto batch = BeginUploadBatch();
+    if (!batch) {
+        return;
+    }
     
-    VkImageMemoryBarrier barrier = {};
+    if (batch->GenerateMipmaps(image, format, width, height, mipLevels) && batch->Submit()) {
+        batch->Wait();
+    }
+}
+
+bool ResourceManager::BuildTransitionBarrier(VkImage image,
+                                            VkFormat format,
+                                            VkImageLayout oldLayout,
+                                            VkImageLayout newLayout,
+                                            uint32_t mipLevels,
+                                            uint32_t layerCount,
+                                            VkImageMemoryBarrier& barrier,
+                                            VkPipelineStageFlags& sourceStage,
+                                            VkPipelineStageFlags& destinationStage) const {
+    barrier = {};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
     barrier.newLayout = newLayout;
@@ -404,9 +562,6 @@ void ResourceManager::TransitionImageLayout(VkImage image,
         }
     }
     
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-    
     if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
         barrier.srcAccessMask = 0;
         barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -419,6 +574,13 @@ void ResourceManager::TransitionImageLayout(VkImage image,
         
         sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
         destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    } else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+        // Updating part of an image that earlier work sampled; its contents are kept
+        barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        
+        sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
     } else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
         barrier.srcAccessMask = 0;
         barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
@@ -427,108 +589,10 @@ void ResourceManager::TransitionImageLayout(VkImage image,
         destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
     } else {
         std::cerr << "ResourceManager: Unsupported layout transition" << std::endl;
-        return;
-    }
-    
-    vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-    
-    m_renderer->EndSingleTimeCommands(commandBuffer);
-}
-
-void ResourceManager::GenerateMipmaps(VkImage image,
-                                     VkFormat format,
-                                     uint32_t width,
-                                     uint32_t height,
-                                     uint32_t mipLevels) {
-    if (!m_initialized) {
-        return;
-    }
-    
-    // Check if image format supports linear blitting
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(m_renderer->GetPhysicalDevice(), format, &formatProperties);
-    
-    if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
-        std::cerr << "ResourceManager: Texture image format does not support linear blitting" << std::endl;
-        return;
-    }
-    
-    VkCommandBuffer commandBuffer = m_renderer->BeginSingleTimeCommands();
-    
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.image = image;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.subresourceRange.levelCount = 1;
-    
-    int32_t mipWidth = static_cast<int32_t>(width);
-    int32_t mipHeight = static_cast<int32_t>(height);
-    
-    for (uint32_t i = 1; i < mipLevels; i++) {
-        barrier.subresourceRange.baseMipLevel = i - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        
-        vkCmdPipelineBarrier(commandBuffer,
-                            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-                            0, nullptr,
-                            0, nullptr,
-                            1, &barrier);
-        
-        VkImageBlit blit = {};
-        blit.srcOffsets[0] = {0, 0, 0};
-        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel = i - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
-        blit.dstOffsets[0] = {0, 0, 0};
-        blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
-        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel = i;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
-        
-        vkCmdBlitImage(commandBuffer,
-                      image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                      image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                      1, &blit,
-                      VK_FILTER_LINEAR);
-        
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        
-        vkCmdPipelineBarrier(commandBuffer,
-                            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-                            0, nullptr,
-                            0, nullptr,
-                            1, &barrier);
-        
-        if (mipWidth > 1) mipWidth /= 2;
-        if (mipHeight > 1) mipHeight /= 2;
+        return false;
     }
     
-    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    
-    vkCmdPipelineBarrier(commandBuffer,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-                        0, nullptr,
-                        0, nullptr,
-                        1, &barrier);
-    
-    m_renderer->EndSingleTimeCommands(commandBuffer);
+    return true;
 }
 
 VkImageView ResourceManager::CreateImageView(VkImage image, 
@@ -561,6 +625,12 @@ bool ResourceManager::HasStencilComponent(VkFormat format) const {
     return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
+bool ResourceManager::SupportsLinearBlit(VkFormat format) const {
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(m_renderer->GetPhysicalDevice(), format, &formatProperties);
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+}
+
 void ResourceManager::GetMemoryUsage(VmaTotalStatistics& stats) const {
     if (!m_initialized) {
         return;
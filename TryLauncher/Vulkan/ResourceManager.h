@@ -1,9 +1,14 @@
 #pragma once
 
 #include "../Engine/Engine.h"
+#include "UploadBatch.h"
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 class VulkanDevice;
 class VulkanRenderer;
@@ -50,7 +55,8 @@ struct AllocatedImage {
  * - VMA integration for optimal memory allocation
  * - Buffer creation for vertex, index, and uniform data
  * - Image creation with format conversion and mipmap support
- * - Staging operations for efficient data transfer
+ * - Staging operations for efficient data transfer, batched through UploadBatch
+ * - Deferred destruction of resources that frames in flight may still use
  * - Resource tracking and automatic cleanup
  */
 class ResourceManager : public IEngineModule {
@@ -68,6 +74,8 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "ResourceManager"; }
     int GetInitializationOrder() const override { return 350; } // After VulkanRenderer (300)
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::AnyThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override { access.Writes(GetName()); }
     
     // Initialization and cleanup
     void Cleanup();
@@ -105,13 +113,30 @@ public:
     void DestroyBuffer(const AllocatedBuffer& buffer);
     void DestroyImage(const AllocatedImage& image);
     
+    // Deferred destruction, safe from any thread. The resource is destroyed once the frame that
+    // retired it, and every earlier graphics submission, has finished on the GPU.
+    void RetireBuffer(const AllocatedBuffer& buffer);
+    void RetireImage(const AllocatedImage& image);
+    void RetireSampler(VkSampler sampler);
+    void Retire(std::function<void()> destroy);
+    
+    // Called by VulkanRenderer::BeginFrame, once the previous frame has been submitted. Never
+    // blocks: destroys what the graphics timeline has moved past.
+    void BeginFrame();
+    
+    // Destroys everything retired so far. Only valid while the GPU is idle.
+    void FlushRetired();
+    
     // Memory mapping utilities
     void* MapBuffer(const AllocatedBuffer& buffer);
     void UnmapBuffer(const AllocatedBuffer& buffer);
     void FlushBuffer(const AllocatedBuffer& buffer, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
     void InvalidateBuffer(const AllocatedBuffer& buffer, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
     
-    // Data transfer utilities
+    // Batched transfers: record any number of copies and transitions, submit once
+    std::unique_ptr<UploadBatch> BeginUploadBatch(UploadQueue queue = UploadQueue::Graphics);
+    
+    // Data transfer utilities. Each is a one-operation batch that waits for completion.
     void CopyBuffer(const AllocatedBuffer& srcBuffer, 
                    const AllocatedBuffer& dstBuffer, 
                    VkDeviceSize size,
@@ -151,6 +176,8 @@ public:
     bool IsInitialized() const { return m_initialized; }
 
 private:
+    friend class UploadBatch;
+    
     // Helper methods
     bool CreateAllocator();
     VkImageView CreateImageView(VkImage image, 
@@ -159,7 +186,30 @@ private:
                                uint32_t mipLevels = 1,
                                VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_2D);
     
+    struct RetiredResource {
+        uint64_t value = 0;     // Graphics timeline value; 0 until the next BeginFrame sets it
+        AllocatedBuffer buffer;
+        AllocatedImage image;
+        VkSampler sampler = VK_NULL_HANDLE;
+        std::function<void()> destroy;
+    };
+    
+    void PushRetired(RetiredResource&& resource);
+    void DestroyRetired(std::vector<RetiredResource>& resources);
+    
     bool HasStencilComponent(VkFormat format) const;
+    bool SupportsLinearBlit(VkFormat format) const;
+    
+    // Fills in the barrier and stage masks for a supported layout transition
+    bool BuildTransitionBarrier(VkImage image,
+                               VkFormat format,
+                               VkImageLayout oldLayout,
+                               VkImageLayout newLayout,
+                               uint32_t mipLevels,
+                               uint32_t layerCount,
+                               VkImageMemoryBarrier& barrier,
+                               VkPipelineStageFlags& sourceStage,
+                               VkPipelineStageFlags& destinationStage) const;
     
     // VMA and Vulkan objects
     VmaAllocator m_allocator = VK_NULL_HANDLE;
@@ -168,6 +218,11 @@ private:
     // State
     bool m_initialized = false;
     
+    // Retired resources in retirement order, so timeline values never decrease
+    std::mutex m_retireMutex;
+    std::deque<RetiredResource> m_retired;
+    std::vector<RetiredResource> m_expired;     // Scratch for BeginFrame, render thread only
+    
     // Statistics tracking
     mutable uint32_t m_allocationCount = 0;
 };
\ No newline at end of file
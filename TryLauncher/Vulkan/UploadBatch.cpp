@@ -0,0 +1,497 @@
+#include "UploadBatch.h"
+#include "ResourceManager.h"
+#include <iostream>
+
+namespace {
+    // Stages a transfer-only queue can execute or wait on
+    constexpr VkPipelineStageFlags TRANSFER_QUEUE_STAGES =
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT |
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT |
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    bool RangesOverlap(uint64_t baseA, uint64_t countA, uint64_t baseB, uint64_t countB) {
+        return baseA < baseB + countB && baseB < baseA + countA;
+    }
+}
+
+UploadBatch::UploadBatch(ResourceManager* resourceManager, VkDevice device,
+                         VulkanTimeline* timeline, uint32_t queueFamily,
+                         VulkanTimeline* graphicsTimeline, uint32_t graphicsFamily)
+    : m_resourceManager(resourceManager), m_device(device),
+      m_timeline(timeline), m_queueFamily(queueFamily),
+      m_graphicsTimeline(graphicsTimeline), m_graphicsFamily(graphicsFamily) {
+}
+
+UploadBatch::~UploadBatch() {
+    // The command buffers and any resources they reference must outlive the GPU work
+    if (m_submitted) {
+        Wait();
+    }
+
+    DestroyStream(m_commands);
+    DestroyStream(m_graphicsCommands);
+}
+
+bool UploadBatch::Begin() {
+    if (!CreateStream(m_commands, m_queueFamily)) {
+        return false;
+    }
+
+    if (UsesOwnershipTransfer() && !CreateStream(m_graphicsCommands, m_graphicsFamily)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool UploadBatch::CreateStream(CommandStream& stream, uint32_t queueFamily) {
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = queueFamily;
+
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &stream.commandPool) != VK_SUCCESS) {
+        std::cerr << "UploadBatch: Failed to create command pool" << std::endl;
+        return false;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = stream.commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(m_device, &allocInfo, &stream.commandBuffer) != VK_SUCCESS) {
+        std::cerr << "UploadBatch: Failed to allocate command buffer" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void UploadBatch::DestroyStream(CommandStream& stream) {
+    if (stream.commandPool != VK_NULL_HANDLE) {
+        // Frees the command buffer with it
+        vkDestroyCommandPool(m_device, stream.commandPool, nullptr);
+        stream.commandPool = VK_NULL_HANDLE;
+        stream.commandBuffer = VK_NULL_HANDLE;
+    }
+}
+
+bool UploadBatch::EnsureRecording(CommandStream& stream) {
+    if (m_closed) {
+        std::cerr << "UploadBatch: Cannot record into a batch that has been submitted" << std::endl;
+        return false;
+    }
+    if (stream.recording) {
+        return true;
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(stream.commandBuffer, &beginInfo) != VK_SUCCESS) {
+        std::cerr << "UploadBatch: Failed to begin command buffer" << std::endl;
+        return false;
+    }
+
+    stream.recording = true;
+    return true;
+}
+
+void UploadBatch::CopyBuffer(const AllocatedBuffer& srcBuffer,
+                             const AllocatedBuffer& dstBuffer,
+                             VkDeviceSize size,
+                             VkDeviceSize srcOffset,
+                             VkDeviceSize dstOffset) {
+    if (!srcBuffer.IsValid() || !dstBuffer.IsValid() || !EnsureRecording(m_commands)) {
+        return;
+    }
+
+    FlushBarriers(m_commands);
+
+    VkBufferCopy copyRegion = {};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = size;
+
+    vkCmdCopyBuffer(m_commands.commandBuffer, srcBuffer.buffer, dstBuffer.buffer, 1, &copyRegion);
+
+    if (UsesOwnershipTransfer() && EnsureRecording(m_graphicsCommands)) {
+        VkBufferMemoryBarrier release = {};
+        release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        release.dstAccessMask = 0;
+        release.srcQueueFamilyIndex = m_queueFamily;
+        release.dstQueueFamilyIndex = m_graphicsFamily;
+        release.buffer = dstBuffer.buffer;
+        release.offset = dstOffset;
+        release.size = size;
+        AddBarrier(m_commands, release, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+        // The buffer's eventual use is unknown here, so make it visible to any read
+        VkBufferMemoryBarrier acquire = release;
+        acquire.srcAccessMask = 0;
+        acquire.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        AddBarrier(m_graphicsCommands, acquire, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+}
+
+void UploadBatch::CopyBufferToImage(const AllocatedBuffer& buffer,
+                                    const AllocatedImage& image,
+                                    uint32_t width,
+                                    uint32_t height,
+                                    uint32_t layerCount,
+                                    VkDeviceSize bufferOffset) {
+    VkBufferImageCopy region = {};
+    region.bufferOffset = bufferOffset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = layerCount;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {width, height, 1};
+
+    RecordImageCopy(buffer, image, region);
+}
+
+void UploadBatch::CopyBufferToImageRegion(const AllocatedBuffer& buffer,
+                                          const AllocatedImage& image,
+                                          VkOffset2D imageOffset,
+                                          uint32_t width,
+                                          uint32_t height,
+                                          VkDeviceSize bufferOffset) {
+    VkBufferImageCopy region = {};
+    region.bufferOffset = bufferOffset;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {imageOffset.x, imageOffset.y, 0};
+    region.imageExtent = {width, height, 1};
+
+    RecordImageCopy(buffer, image, region);
+}
+
+void UploadBatch::RecordImageCopy(const AllocatedBuffer& buffer,
+                                  const AllocatedImage& image,
+                                  const VkBufferImageCopy& region) {
+    // Graphics keeps an image it already owns, so the copy runs where its transitions do
+    CommandStream& stream = (UsesOwnershipTransfer() && IsGraphicsOwned(image.image)) ? m_graphicsCommands : m_commands;
+    if (!buffer.IsValid() || !image.IsValid() || !EnsureRecording(stream)) {
+        return;
+    }
+
+    FlushBarriers(stream);
+
+    vkCmdCopyBufferToImage(stream.commandBuffer, buffer.buffer, image.image,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+}
+
+bool UploadBatch::TransitionImageLayout(VkImage image,
+                                        VkFormat format,
+                                        VkImageLayout oldLayout,
+                                        VkImageLayout newLayout,
+                                        uint32_t mipLevels,
+                                        uint32_t layerCount) {
+    VkImageMemoryBarrier barrier = {};
+    VkPipelineStageFlags sourceStage = 0;
+    VkPipelineStageFlags destinationStage = 0;
+
+    if (!m_resourceManager->BuildTransitionBarrier(image, format, oldLayout, newLayout, mipLevels, layerCount,
+                                                   barrier, sourceStage, destinationStage)) {
+        return false;
+    }
+
+    bool graphicsOwned = UsesOwnershipTransfer() && IsGraphicsOwned(image);
+    if (!UsesOwnershipTransfer() ||
+        (!graphicsOwned && ((sourceStage | destinationStage) & ~TRANSFER_QUEUE_STAGES) == 0)) {
+        if (!EnsureRecording(m_commands)) {
+            return false;
+        }
+        AddBarrier(m_commands, barrier, sourceStage, destinationStage);
+    } else if (graphicsOwned || oldLayout == VK_IMAGE_LAYOUT_UNDEFINED ||
+               (sourceStage & ~TRANSFER_QUEUE_STAGES) != 0) {
+        // Nothing to hand over: the contents are discarded, or graphics already owns the image.
+        // It then stays on graphics for the rest of the batch; see RecordImageCopy.
+        if (!EnsureRecording(m_graphicsCommands)) {
+            return false;
+        }
+        AddBarrier(m_graphicsCommands, barrier, sourceStage, destinationStage);
+        m_graphicsOwnedImages.insert(image);
+    } else {
+        if (!EnsureRecording(m_commands) || !EnsureRecording(m_graphicsCommands)) {
+            return false;
+        }
+        TransferOwnership(barrier, sourceStage, destinationStage);
+    }
+
+    return true;
+}
+
+bool UploadBatch::GenerateMipmaps(VkImage image,
+                                  VkFormat format,
+                                  uint32_t width,
+                                  uint32_t height,
+                                  uint32_t mipLevels) {
+    if (!m_resourceManager->SupportsLinearBlit(format)) {
+        std::cerr << "ResourceManager: Texture image format does not support linear blitting" << std::endl;
+        return false;
+    }
+
+    // Blits need a graphics queue; take the whole image over before recording them there
+    CommandStream& stream = GraphicsStream();
+    if (UsesOwnershipTransfer() && IsGraphicsOwned(image)) {
+        if (!EnsureRecording(stream)) {
+            return false;
+        }
+    } else if (UsesOwnershipTransfer()) {
+        if (!EnsureRecording(m_commands) || !EnsureRecording(m_graphicsCommands)) {
+            return false;
+        }
+
+        VkImageMemoryBarrier handover = {};
+        handover.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        handover.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        handover.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        handover.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        handover.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        handover.image = image;
+        handover.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        handover.subresourceRange.baseMipLevel = 0;
+        handover.subresourceRange.levelCount = mipLevels;
+        handover.subresourceRange.baseArrayLayer = 0;
+        handover.subresourceRange.layerCount = 1;
+        TransferOwnership(handover, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        m_graphicsOwnedImages.insert(image);
+    } else if (!EnsureRecording(stream)) {
+        return false;
+    }
+
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.image = image;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.levelCount = 1;
+
+    int32_t mipWidth = static_cast<int32_t>(width);
+    int32_t mipHeight = static_cast<int32_t>(height);
+
+    for (uint32_t i = 1; i < mipLevels; i++) {
+        // Joins the previous level's transition to shader read in one barrier
+        barrier.subresourceRange.baseMipLevel = i - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        AddBarrier(stream, barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        FlushBarriers(stream);
+
+        VkImageBlit blit = {};
+        blit.srcOffsets[0] = {0, 0, 0};
+        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = i - 1;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount = 1;
+        blit.dstOffsets[0] = {0, 0, 0};
+        blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
+        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.dstSubresource.mipLevel = i;
+        blit.dstSubresource.baseArrayLayer = 0;
+        blit.dstSubresource.layerCount = 1;
+
+        vkCmdBlitImage(stream.commandBuffer,
+                      image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                      image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                      1, &blit,
+                      VK_FILTER_LINEAR);
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        AddBarrier(stream, barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+        if (mipWidth > 1) mipWidth /= 2;
+        if (mipHeight > 1) mipHeight /= 2;
+    }
+
+    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    AddBarrier(stream, barrier, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    return true;
+}
+
+void UploadBatch::TransferOwnership(const VkImageMemoryBarrier& barrier,
+                                    VkPipelineStageFlags srcStage,
+                                    VkPipelineStageFlags dstStage) {
+    // The release and acquire must describe the same layout transition; it happens once,
+    // between the two. Each side only carries its own access mask.
+    VkImageMemoryBarrier release = barrier;
+    release.srcQueueFamilyIndex = m_queueFamily;
+    release.dstQueueFamilyIndex = m_graphicsFamily;
+    release.dstAccessMask = 0;
+    AddBarrier(m_commands, release, srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    // Ordered after the release by the graphics submission waiting for the transfer timeline
+    VkImageMemoryBarrier acquire = release;
+    acquire.srcAccessMask = 0;
+    acquire.dstAccessMask = barrier.dstAccessMask;
+    AddBarrier(m_graphicsCommands, acquire, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStage);
+}
+
+void UploadBatch::AddBarrier(CommandStream& stream,
+                             const VkImageMemoryBarrier& barrier,
+                             VkPipelineStageFlags srcStage,
+                             VkPipelineStageFlags dstStage) {
+    // Two transitions of the same subresources must stay ordered, so they cannot share a barrier
+    const VkImageSubresourceRange& range = barrier.subresourceRange;
+    for (const VkImageMemoryBarrier& pending : stream.imageBarriers) {
+        const VkImageSubresourceRange& other = pending.subresourceRange;
+        if (pending.image == barrier.image &&
+            RangesOverlap(range.baseMipLevel, range.levelCount, other.baseMipLevel, other.levelCount) &&
+            RangesOverlap(range.baseArrayLayer, range.layerCount, other.baseArrayLayer, other.layerCount)) {
+            FlushBarriers(stream);
+            break;
+        }
+    }
+
+    stream.imageBarriers.push_back(barrier);
+    stream.srcStages |= srcStage;
+    stream.dstStages |= dstStage;
+}
+
+void UploadBatch::AddBarrier(CommandStream& stream,
+                             const VkBufferMemoryBarrier& barrier,
+                             VkPipelineStageFlags srcStage,
+                             VkPipelineStageFlags dstStage) {
+    for (const VkBufferMemoryBarrier& pending : stream.bufferBarriers) {
+        if (pending.buffer == barrier.buffer &&
+            RangesOverlap(barrier.offset, barrier.size, pending.offset, pending.size)) {
+            FlushBarriers(stream);
+            break;
+        }
+    }
+
+    stream.bufferBarriers.push_back(barrier);
+    stream.srcStages |= srcStage;
+    stream.dstStages |= dstStage;
+}
+
+void UploadBatch::FlushBarriers(CommandStream& stream) {
+    if (stream.imageBarriers.empty() && stream.bufferBarriers.empty()) {
+        return;
+    }
+
+    vkCmdPipelineBarrier(stream.commandBuffer, stream.srcStages, stream.dstStages, 0,
+                        0, nullptr,
+                        static_cast<uint32_t>(stream.bufferBarriers.size()), stream.bufferBarriers.data(),
+                        static_cast<uint32_t>(stream.imageBarriers.size()), stream.imageBarriers.data());
+
+    stream.imageBarriers.clear();
+    stream.bufferBarriers.clear();
+    stream.srcStages = 0;
+    stream.dstStages = 0;
+}
+
+bool UploadBatch::EndStream(CommandStream& stream) {
+    if (!stream.recording) {
+        return true;
+    }
+
+    FlushBarriers(stream);
+    if (vkEndCommandBuffer(stream.commandBuffer) != VK_SUCCESS) {
+        std::cerr << "UploadBatch: Failed to end command buffer" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool UploadBatch::Submit() {
+    if (m_closed) {
+        std::cerr << "UploadBatch: Batch has already been submitted" << std::endl;
+        return false;
+    }
+    m_closed = true;
+
+    if (!EndStream(m_commands) || !EndStream(m_graphicsCommands)) {
+        return false;
+    }
+
+    // The timelines serialize submissions, which may come from any thread
+    VulkanTimeline::SubmitDesc submit;
+    if (m_commands.recording) {
+        submit.commandBuffers.push_back(m_commands.commandBuffer);
+    }
+
+    if (!m_graphicsCommands.recording) {
+        uint64_t value = m_timeline->Submit(submit);
+        if (value == 0) {
+            std::cerr << "UploadBatch: Failed to submit" << std::endl;
+            return false;
+        }
+        m_completionTimeline = m_timeline;
+        m_completionValue = value;
+        m_submitted = true;
+        return true;
+    }
+
+    // Transfer queue signals its timeline, graphics queue waits for that value and acquires
+    VulkanTimeline::SubmitDesc acquire;
+    acquire.commandBuffers.push_back(m_graphicsCommands.commandBuffer);
+
+    uint64_t transferValue = 0;
+    if (m_commands.recording) {
+        transferValue = m_timeline->Submit(submit);
+        if (transferValue == 0) {
+            std::cerr << "UploadBatch: Failed to submit transfer commands" << std::endl;
+            return false;
+        }
+        acquire.waits.push_back(m_timeline->At(transferValue));
+    }
+
+    uint64_t value = m_graphicsTimeline->Submit(acquire);
+    if (value == 0) {
+        std::cerr << "UploadBatch: Failed to submit acquire commands" << std::endl;
+        // The transfer half may already be running; it must finish before the batch is freed
+        if (transferValue != 0) {
+            m_timeline->Wait(transferValue);
+        }
+        return false;
+    }
+
+    m_completionTimeline = m_graphicsTimeline;
+    m_completionValue = value;
+    m_submitted = true;
+    return true;
+}
+
+bool UploadBatch::IsComplete() const {
+    return m_submitted && m_completionTimeline->IsComplete(m_completionValue);
+}
+
+void UploadBatch::Wait() {
+    if (!m_submitted) {
+        return;
+    }
+    m_completionTimeline->Wait(m_completionValue);
+}
+
+VulkanTimeline::WaitPoint UploadBatch::GetCompletion(VkPipelineStageFlags stages) const {
+    if (!m_submitted) {
+        return VulkanTimeline::WaitPoint();
+    }
+    return m_completionTimeline->At(m_completionValue, stages);
+}
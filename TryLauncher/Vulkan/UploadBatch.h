@@ -0,0 +1,160 @@
+#pragma once
+
+#include "VulkanTimeline.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+class ResourceManager;
+struct AllocatedBuffer;
+struct AllocatedImage;
+
+// Queue an UploadBatch is submitted to
+enum class UploadQueue {
+    Graphics,
+    Transfer    // Dedicated transfer family when the device has one
+};
+
+/**
+ * UploadBatch accumulates transfer work into a single command buffer.
+ * This class handles:
+ * - Recording buffer and image copies and mipmap blits
+ * - Collecting layout transitions and emitting each run of them as one merged pipeline barrier
+ * - Submitting once on the queue's timeline, so callers can poll or wait instead of idling the queue
+ * - Handing results from a dedicated transfer family to the graphics family
+ *
+ * Batches are created by ResourceManager::BeginUploadBatch and own their command pools,
+ * so independent batches may be recorded on different threads. A batch is single-use:
+ * after Submit() only IsComplete() and Wait() are meaningful.
+ *
+ * When a Transfer batch runs on a family other than graphics, copies execute on the
+ * transfer queue and every resource they write is released to the graphics family.
+ * A second command buffer on the graphics queue waits for the transfer timeline, acquires
+ * those resources and performs the work a transfer queue cannot (shader-read transitions,
+ * mipmap blits). The batch completes once both have finished. Destinations are written
+ * without being acquired first, so a batch must not rely on earlier contents of
+ * regions it does not overwrite.
+ *
+ * An image graphics already uses, i.e. one whose transition leaves a shader stage, is
+ * never handed to the transfer family: its transitions, copies and blits for the rest of
+ * the batch all run on the graphics queue. Partial updates such as a new entry in an
+ * atlas page keep the rest of the image that way.
+ */
+class UploadBatch {
+public:
+    ~UploadBatch();
+
+    UploadBatch(const UploadBatch&) = delete;
+    UploadBatch& operator=(const UploadBatch&) = delete;
+
+    // Recording
+    void CopyBuffer(const AllocatedBuffer& srcBuffer,
+                   const AllocatedBuffer& dstBuffer,
+                   VkDeviceSize size,
+                   VkDeviceSize srcOffset = 0,
+                   VkDeviceSize dstOffset = 0);
+
+    void CopyBufferToImage(const AllocatedBuffer& buffer,
+                          const AllocatedImage& image,
+                          uint32_t width,
+                          uint32_t height,
+                          uint32_t layerCount = 1,
+                          VkDeviceSize bufferOffset = 0);
+
+    // Copies into part of mip level 0, e.g. one entry of an atlas
+    void CopyBufferToImageRegion(const AllocatedBuffer& buffer,
+                                const AllocatedImage& image,
+                                VkOffset2D imageOffset,
+                                uint32_t width,
+                                uint32_t height,
+                                VkDeviceSize bufferOffset = 0);
+
+    bool TransitionImageLayout(VkImage image,
+                              VkFormat format,
+                              VkImageLayout oldLayout,
+                              VkImageLayout newLayout,
+                              uint32_t mipLevels = 1,
+                              uint32_t layerCount = 1);
+
+    // Expects every level in TRANSFER_DST_OPTIMAL; leaves them SHADER_READ_ONLY_OPTIMAL
+    bool GenerateMipmaps(VkImage image,
+                        VkFormat format,
+                        uint32_t width,
+                        uint32_t height,
+                        uint32_t mipLevels);
+
+    bool IsEmpty() const { return !m_commands.recording && !m_graphicsCommands.recording; }
+    // True when copies run on a dedicated transfer family
+    bool UsesOwnershipTransfer() const { return m_queueFamily != m_graphicsFamily; }
+
+    // Submission. An empty batch submits no commands but still signals its timeline.
+    bool Submit();
+    bool IsSubmitted() const { return m_submitted; }
+    // False until submitted work has finished on the GPU
+    bool IsComplete() const;
+    void Wait();
+    // For a submission that uses the results to wait on the GPU instead; only once submitted
+    VulkanTimeline::WaitPoint GetCompletion(VkPipelineStageFlags stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT) const;
+
+private:
+    friend class ResourceManager;
+
+    // One command buffer with the barriers waiting to be emitted before its next command
+    struct CommandStream {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        bool recording = false;
+
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+    };
+
+    UploadBatch(ResourceManager* resourceManager, VkDevice device,
+                VulkanTimeline* timeline, uint32_t queueFamily,
+                VulkanTimeline* graphicsTimeline, uint32_t graphicsFamily);
+
+    bool Begin();
+    bool CreateStream(CommandStream& stream, uint32_t queueFamily);
+    void DestroyStream(CommandStream& stream);
+    bool EnsureRecording(CommandStream& stream);
+    void RecordImageCopy(const AllocatedBuffer& buffer,
+                         const AllocatedImage& image,
+                         const VkBufferImageCopy& region);
+    bool IsGraphicsOwned(VkImage image) const { return m_graphicsOwnedImages.count(image) != 0; }
+    // Work that needs the graphics family: the acquire stream when transferring ownership
+    CommandStream& GraphicsStream() { return UsesOwnershipTransfer() ? m_graphicsCommands : m_commands; }
+
+    void AddBarrier(CommandStream& stream,
+                    const VkImageMemoryBarrier& barrier,
+                    VkPipelineStageFlags srcStage,
+                    VkPipelineStageFlags dstStage);
+    void AddBarrier(CommandStream& stream,
+                    const VkBufferMemoryBarrier& barrier,
+                    VkPipelineStageFlags srcStage,
+                    VkPipelineStageFlags dstStage);
+    void FlushBarriers(CommandStream& stream);
+    bool EndStream(CommandStream& stream);
+
+    // Releases from the transfer family and acquires on graphics with the given final state
+    void TransferOwnership(const VkImageMemoryBarrier& barrier,
+                           VkPipelineStageFlags srcStage,
+                           VkPipelineStageFlags dstStage);
+
+    ResourceManager* m_resourceManager;
+    VkDevice m_device;
+    VulkanTimeline* m_timeline;
+    uint32_t m_queueFamily;
+    VulkanTimeline* m_graphicsTimeline;
+    uint32_t m_graphicsFamily;
+
+    CommandStream m_commands;           // Runs on m_timeline's queue
+    CommandStream m_graphicsCommands;   // Acquires on the graphics queue; only with ownership transfer
+    std::unordered_set<VkImage> m_graphicsOwnedImages;  // Recorded on m_graphicsCommands only
+    bool m_closed = false;      // Submit() was called; no further recording
+    bool m_submitted = false;   // m_completionTimeline will reach m_completionValue
+    VulkanTimeline* m_completionTimeline = nullptr;
+    uint64_t m_completionValue = 0;
+};
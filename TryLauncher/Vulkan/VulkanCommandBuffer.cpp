@@ -1,5 +1,6 @@
 #include "VulkanCommandBuffer.h"
 #include "VulkanDevice.h"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -24,6 +25,7 @@ bool VulkanCommandBuffer::Initialize(const InitInfo& info) {
     m_queueFamilyIndex = info.queueFamilyIndex;
     m_poolFlags = info.poolFlags;
     m_initialCommandBufferCount = info.initialCommandBufferCount;
+    m_frames = std::vector<FrameSlot>(std::max(info.frameCount, 1u));
     
     try {
         if (!CreateCommandPool()) {
@@ -61,6 +63,25 @@ void VulkanCommandBuffer::Cleanup() {
     // Wait for device to be idle before cleanup
     vkDeviceWaitIdle(device);
     
+    // Destroying a pool frees its command buffers
+    for (FrameSlot& slot : m_frames) {
+        for (auto& entry : slot.threadPools) {
+            vkDestroyCommandPool(device, entry.second->commandPool, nullptr);
+        }
+        slot.threadPools.clear();
+        slot.timelineValue = 0;
+    }
+    m_frameStarted = false;
+    
+    for (const OneShotPool& oneShot : m_freeOneShotPools) {
+        vkDestroyCommandPool(device, oneShot.commandPool, nullptr);
+    }
+    for (const auto& entry : m_activeOneShotPools) {
+        vkDestroyCommandPool(device, entry.second.commandPool, nullptr);
+    }
+    m_freeOneShotPools.clear();
+    m_activeOneShotPools.clear();
+    
     // Free command buffers
     if (!m_commandBuffers.empty() && m_commandPool != VK_NULL_HANDLE) {
         vkFreeCommandBuffers(device, m_commandPool, 
@@ -143,7 +164,8 @@ void VulkanCommandBuffer::FreeCommandBuffers(const std::vector<VkCommandBuffer>&
                         commandBuffers.data());
 }
 
-bool VulkanCommandBuffer::BeginRecording(VkCommandBuffer commandBuffer, VkCommandBufferUsageFlags usage) {
+bool VulkanCommandBuffer::BeginRecording(VkCommandBuffer commandBuffer, VkCommandBufferUsageFlags usage,
+                                         const VkCommandBufferInheritanceInfo* inheritance) {
     if (!m_initialized || commandBuffer == VK_NULL_HANDLE) {
         std::cerr << "Invalid command buffer or VulkanCommandBuffer not initialized" << std::endl;
         return false;
@@ -152,7 +174,7 @@ bool VulkanCommandBuffer::BeginRecording(VkCommandBuffer commandBuffer, VkComman
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = usage;
-    beginInfo.pInheritanceInfo = nullptr; // Only relevant for secondary command buffers
+    beginInfo.pInheritanceInfo = inheritance; // Only relevant for secondary command buffers
     
     VkResult result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
     if (result != VK_SUCCESS) {
@@ -178,19 +200,127 @@ bool VulkanCommandBuffer::EndRecording(VkCommandBuffer commandBuffer) {
     return true;
 }
 
+void VulkanCommandBuffer::BeginFrame(uint32_t frameIndex) {
+    if (!m_initialized || !m_device) {
+        return;
+    }
+    
+    VulkanTimeline* timeline = m_device->GetGraphicsTimeline();
+    std::lock_guard<std::mutex> lock(m_frameMutex);
+    
+    // The previous frame has been submitted by now, so the latest value covers its buffers
+    if (m_frameStarted) {
+        m_frames[m_currentFrame].timelineValue = timeline->GetSubmittedValue();
+    }
+    m_currentFrame = frameIndex % static_cast<uint32_t>(m_frames.size());
+    m_frameStarted = true;
+    
+    FrameSlot& slot = m_frames[m_currentFrame];
+    timeline->Wait(slot.timelineValue);
+    
+    // One reset per pool returns all of its buffers to the initial state
+    for (auto& entry : slot.threadPools) {
+        ThreadPool& pool = *entry.second;
+        VkResult result = vkResetCommandPool(m_device->GetDevice(), pool.commandPool, 0);
+        if (result != VK_SUCCESS) {
+            std::cerr << "Failed to reset frame command pool! Error code: " << result << std::endl;
+        }
+        pool.primaryUsed = 0;
+        pool.secondaryUsed = 0;
+    }
+}
+
+VkCommandBuffer VulkanCommandBuffer::AllocateFrameCommandBuffer(VkCommandBufferLevel level) {
+    if (!m_initialized || !m_device) {
+        throw std::runtime_error("VulkanCommandBuffer not initialized");
+    }
+    
+    ThreadPool* pool = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        if (!m_frameStarted) {
+            throw std::runtime_error("Frame command buffer requested before BeginFrame");
+        }
+        
+        std::unique_ptr<ThreadPool>& threadPool = m_frames[m_currentFrame].threadPools[std::this_thread::get_id()];
+        if (!threadPool) {
+            VkCommandPool commandPool = CreatePool(VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+            if (commandPool == VK_NULL_HANDLE) {
+                throw std::runtime_error("Failed to create frame command pool");
+            }
+            threadPool = std::make_unique<ThreadPool>();
+            threadPool->commandPool = commandPool;
+        }
+        pool = threadPool.get();
+    }
+    
+    // Only this thread uses its pool until the slot is begun again
+    bool primary = (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    std::vector<VkCommandBuffer>& buffers = primary ? pool->primaryBuffers : pool->secondaryBuffers;
+    size_t& used = primary ? pool->primaryUsed : pool->secondaryUsed;
+    
+    if (used == buffers.size()) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = pool->commandPool;
+        allocInfo.level = level;
+        allocInfo.commandBufferCount = 1;
+        
+        VkCommandBuffer commandBuffer;
+        VkResult result = vkAllocateCommandBuffers(m_device->GetDevice(), &allocInfo, &commandBuffer);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate frame command buffer! Error code: " + std::to_string(result));
+        }
+        buffers.push_back(commandBuffer);
+    }
+    
+    return buffers[used++];
+}
+
 VkCommandBuffer VulkanCommandBuffer::BeginSingleTimeCommands() {
     if (!m_initialized || !m_device) {
         throw std::runtime_error("VulkanCommandBuffer not initialized");
     }
     
-    VkCommandBuffer commandBuffer = AllocateCommandBuffer();
+    OneShotPool oneShot;
+    {
+        std::lock_guard<std::mutex> lock(m_oneShotMutex);
+        if (!m_freeOneShotPools.empty()) {
+            oneShot = m_freeOneShotPools.back();
+            m_freeOneShotPools.pop_back();
+        }
+    }
     
-    if (!BeginRecording(commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)) {
-        FreeCommandBuffer(commandBuffer);
+    if (oneShot.commandPool == VK_NULL_HANDLE) {
+        oneShot.commandPool = CreatePool(VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        if (oneShot.commandPool == VK_NULL_HANDLE) {
+            throw std::runtime_error("Failed to create single-time command pool");
+        }
+        
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = oneShot.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        
+        VkResult result = vkAllocateCommandBuffers(m_device->GetDevice(), &allocInfo, &oneShot.commandBuffer);
+        if (result != VK_SUCCESS) {
+            vkDestroyCommandPool(m_device->GetDevice(), oneShot.commandPool, nullptr);
+            throw std::runtime_error("Failed to allocate single-time command buffer! Error code: " + std::to_string(result));
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_oneShotMutex);
+        m_activeOneShotPools[oneShot.commandBuffer] = oneShot;
+    }
+    
+    if (!BeginRecording(oneShot.commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)) {
+        RecycleOneShotPool(oneShot.commandBuffer);
         throw std::runtime_error("Failed to begin recording single-time command buffer");
     }
     
-    return commandBuffer;
+    return oneShot.commandBuffer;
 }
 
 void VulkanCommandBuffer::EndSingleTimeCommands(VkCommandBuffer commandBuffer) {
@@ -199,76 +329,93 @@ void VulkanCommandBuffer::EndSingleTimeCommands(VkCommandBuffer commandBuffer) {
     }
     
     if (!EndRecording(commandBuffer)) {
-        FreeCommandBuffer(commandBuffer);
+        RecycleOneShotPool(commandBuffer);
         throw std::runtime_error("Failed to end recording single-time command buffer");
     }
     
     // Submit the command buffer
     SubmitInfo submitInfo;
     submitInfo.commandBuffers = { commandBuffer };
-    submitInfo.queue = m_device->GetGraphicsQueue();
     
-    if (!SubmitCommandBuffers(submitInfo)) {
-        FreeCommandBuffer(commandBuffer);
+    uint64_t value = SubmitCommandBuffers(submitInfo);
+    if (value == 0) {
+        RecycleOneShotPool(commandBuffer);
         throw std::runtime_error("Failed to submit single-time command buffer");
     }
     
-    // Wait for completion and free the command buffer
-    vkQueueWaitIdle(m_device->GetGraphicsQueue());
-    FreeCommandBuffer(commandBuffer);
+    // Wait for this submission only, then the pool can be reused
+    m_device->GetGraphicsTimeline()->Wait(value);
+    RecycleOneShotPool(commandBuffer);
+}
+
+void VulkanCommandBuffer::RecycleOneShotPool(VkCommandBuffer commandBuffer) {
+    std::lock_guard<std::mutex> lock(m_oneShotMutex);
+    
+    auto it = m_activeOneShotPools.find(commandBuffer);
+    if (it == m_activeOneShotPools.end()) {
+        return;
+    }
+    
+    // Its work is not pending, so resetting the pool returns the buffer to the initial state
+    OneShotPool oneShot = it->second;
+    m_activeOneShotPools.erase(it);
+    vkResetCommandPool(m_device->GetDevice(), oneShot.commandPool, 0);
+    m_freeOneShotPools.push_back(oneShot);
 }
 
-bool VulkanCommandBuffer::SubmitCommandBuffers(const SubmitInfo& submitInfo) {
+uint64_t VulkanCommandBuffer::SubmitCommandBuffers(const SubmitInfo& submitInfo) {
     if (!m_initialized || !m_device) {
         std::cerr << "VulkanCommandBuffer not initialized" << std::endl;
-        return false;
+        return 0;
     }
     
     if (submitInfo.commandBuffers.empty()) {
         std::cerr << "No command buffers to submit" << std::endl;
-        return false;
+        return 0;
     }
     
     // Use graphics queue if no queue specified
-    VkQueue queue = submitInfo.queue;
-    if (queue == VK_NULL_HANDLE) {
-        queue = m_device->GetGraphicsQueue();
+    VulkanTimeline* timeline = submitInfo.timeline;
+    if (!timeline) {
+        timeline = m_device->GetGraphicsTimeline();
     }
     
-    if (queue == VK_NULL_HANDLE) {
+    if (!timeline) {
         std::cerr << "No valid queue for command buffer submission" << std::endl;
-        return false;
+        return 0;
     }
     
     // Validate wait semaphores and stages match
     if (submitInfo.waitSemaphores.size() != submitInfo.waitStages.size()) {
         std::cerr << "Wait semaphores and wait stages count mismatch" << std::endl;
-        return false;
+        return 0;
     }
     
-    VkSubmitInfo vkSubmitInfo{};
-    vkSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    
-    // Wait semaphores
-    vkSubmitInfo.waitSemaphoreCount = static_cast<uint32_t>(submitInfo.waitSemaphores.size());
-    vkSubmitInfo.pWaitSemaphores = submitInfo.waitSemaphores.empty() ? nullptr : submitInfo.waitSemaphores.data();
-    vkSubmitInfo.pWaitDstStageMask = submitInfo.waitStages.empty() ? nullptr : submitInfo.waitStages.data();
+    if (!submitInfo.waitValues.empty() && submitInfo.waitValues.size() != submitInfo.waitSemaphores.size()) {
+        std::cerr << "Wait semaphores and wait values count mismatch" << std::endl;
+        return 0;
+    }
     
-    // Command buffers
-    vkSubmitInfo.commandBufferCount = static_cast<uint32_t>(submitInfo.commandBuffers.size());
-    vkSubmitInfo.pCommandBuffers = submitInfo.commandBuffers.data();
+    VulkanTimeline::SubmitDesc desc;
+    desc.commandBuffers = submitInfo.commandBuffers;
+    desc.signalSemaphores = submitInfo.signalSemaphores;
+    desc.fence = submitInfo.fence;
     
-    // Signal semaphores
-    vkSubmitInfo.signalSemaphoreCount = static_cast<uint32_t>(submitInfo.signalSemaphores.size());
-    vkSubmitInfo.pSignalSemaphores = submitInfo.signalSemaphores.empty() ? nullptr : submitInfo.signalSemaphores.data();
+    // Wait semaphores
+    for (size_t i = 0; i < submitInfo.waitSemaphores.size(); i++) {
+        VulkanTimeline::WaitPoint wait;
+        wait.semaphore = submitInfo.waitSemaphores[i];
+        wait.value = submitInfo.waitValues.empty() ? 0 : submitInfo.waitValues[i];
+        wait.stages = submitInfo.waitStages[i];
+        desc.waits.push_back(wait);
+    }
     
-    VkResult result = vkQueueSubmit(queue, 1, &vkSubmitInfo, submitInfo.fence);
-    if (result != VK_SUCCESS) {
-        std::cerr << "Failed to submit command buffer! Error code: " << result << std::endl;
-        return false;
+    uint64_t value = timeline->Submit(desc);
+    if (value == 0) {
+        std::cerr << "Failed to submit command buffer!" << std::endl;
     }
     
-    return true;
+    return value;
 }
 
 bool VulkanCommandBuffer::ExecuteImmediate(std::function<void(VkCommandBuffer)> recordingFunction) {
@@ -313,18 +460,24 @@ VkCommandBuffer VulkanCommandBuffer::GetCommandBuffer(uint32_t index) const {
 }
 
 bool VulkanCommandBuffer::CreateCommandPool() {
+    m_commandPool = CreatePool(m_poolFlags);
+    return m_commandPool != VK_NULL_HANDLE;
+}
+
+VkCommandPool VulkanCommandBuffer::CreatePool(VkCommandPoolCreateFlags flags) const {
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.flags = m_poolFlags;
+    poolInfo.flags = flags;
     poolInfo.queueFamilyIndex = m_queueFamilyIndex;
     
-    VkResult result = vkCreateCommandPool(m_device->GetDevice(), &poolInfo, nullptr, &m_commandPool);
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkResult result = vkCreateCommandPool(m_device->GetDevice(), &poolInfo, nullptr, &commandPool);
     if (result != VK_SUCCESS) {
         std::cerr << "Failed to create command pool! Error code: " << result << std::endl;
-        return false;
+        return VK_NULL_HANDLE;
     }
     
-    return true;
+    return commandPool;
 }
 
 bool VulkanCommandBuffer::AllocateInitialCommandBuffers() {
@@ -1,16 +1,25 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 class VulkanDevice;
+class VulkanTimeline;
 
 /**
  * VulkanCommandBuffer provides a comprehensive command buffer management system
  * for the Vulkan renderer. It handles command pool creation, command buffer allocation,
  * recording utilities, and submission with proper synchronization.
+ *
+ * Per-frame work records from a ring of frame slots, each holding one transient pool per
+ * recording thread. A slot's pools are reset wholesale when the slot comes around again,
+ * which is cheaper than resetting buffers one by one and lets threads record in parallel.
  */
 class VulkanCommandBuffer {
 public:
@@ -19,6 +28,7 @@ public:
         uint32_t queueFamilyIndex = 0;
         VkCommandPoolCreateFlags poolFlags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
         uint32_t initialCommandBufferCount = 1;
+        uint32_t frameCount = 2;    // Slots in the per-frame pool ring
     };
     
     VulkanCommandBuffer();
@@ -38,10 +48,19 @@ public:
     void FreeCommandBuffers(const std::vector<VkCommandBuffer>& commandBuffers);
     
     // Command buffer recording utilities
-    bool BeginRecording(VkCommandBuffer commandBuffer, VkCommandBufferUsageFlags usage = 0);
+    // Secondary command buffers that continue a render pass need its inheritance info
+    bool BeginRecording(VkCommandBuffer commandBuffer, VkCommandBufferUsageFlags usage = 0,
+                        const VkCommandBufferInheritanceInfo* inheritance = nullptr);
     bool EndRecording(VkCommandBuffer commandBuffer);
     
-    // Single-time command support
+    // Per-frame recording. BeginFrame starts a slot: it waits for the slot's previous frame
+    // (normally already done by the swapchain) and resets each of the slot's pools. Any thread
+    // may then allocate from its own pool; buffers stay valid until the slot is begun again.
+    void BeginFrame(uint32_t frameIndex);
+    VkCommandBuffer AllocateFrameCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    
+    // Single-time command support, safe from any thread. Each one records into a transient
+    // pool of its own, which is reset and recycled once its work completes.
     VkCommandBuffer BeginSingleTimeCommands();
     void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
     
@@ -49,13 +68,15 @@ public:
     struct SubmitInfo {
         std::vector<VkCommandBuffer> commandBuffers;
         std::vector<VkSemaphore> waitSemaphores;
+        std::vector<uint64_t> waitValues;       // Per wait semaphore for timelines; empty if all are binary
         std::vector<VkPipelineStageFlags> waitStages;
         std::vector<VkSemaphore> signalSemaphores;
         VkFence fence = VK_NULL_HANDLE;
-        VkQueue queue = VK_NULL_HANDLE; // If null, uses graphics queue
+        VulkanTimeline* timeline = nullptr;     // Queue to submit to; if null, uses graphics queue
     };
     
-    bool SubmitCommandBuffers(const SubmitInfo& submitInfo);
+    // Returns the timeline value the submission signals, or 0 if it failed
+    uint64_t SubmitCommandBuffers(const SubmitInfo& submitInfo);
     
     // Convenience methods for common operations
     bool ExecuteImmediate(std::function<void(VkCommandBuffer)> recordingFunction);
@@ -72,9 +93,31 @@ public:
     bool IsInitialized() const { return m_initialized; }
 
 private:
+    // One thread's pool in a frame slot; its buffers are handed out again after each reset
+    struct ThreadPool {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> primaryBuffers;
+        std::vector<VkCommandBuffer> secondaryBuffers;
+        size_t primaryUsed = 0;
+        size_t secondaryUsed = 0;
+    };
+    
+    struct FrameSlot {
+        std::unordered_map<std::thread::id, std::unique_ptr<ThreadPool>> threadPools;
+        uint64_t timelineValue = 0;     // Graphics timeline value covering the slot's last frame
+    };
+    
+    // A transient pool with the one command buffer of a single-time submission
+    struct OneShotPool {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    };
+    
     // Helper methods
     bool CreateCommandPool();
+    VkCommandPool CreatePool(VkCommandPoolCreateFlags flags) const;
     bool AllocateInitialCommandBuffers();
+    void RecycleOneShotPool(VkCommandBuffer commandBuffer);
     
     // Vulkan objects
     VulkanDevice* m_device = nullptr;
@@ -86,6 +129,17 @@ private:
     VkCommandPoolCreateFlags m_poolFlags = 0;
     uint32_t m_initialCommandBufferCount = 1;
     
+    // Per-frame pool ring
+    std::mutex m_frameMutex;
+    std::vector<FrameSlot> m_frames;
+    uint32_t m_currentFrame = 0;
+    bool m_frameStarted = false;
+    
+    // Single-time pools, ready for reuse or recording
+    std::mutex m_oneShotMutex;
+    std::vector<OneShotPool> m_freeOneShotPools;
+    std::unordered_map<VkCommandBuffer, OneShotPool> m_activeOneShotPools;
+    
     // State
     bool m_initialized = false;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <set>
 #include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 VulkanDevice::VulkanDevice() = default;
@@ -41,6 +42,16 @@ bool VulkanDevice::Initialize(const InitInfo& info) {
             return false;
         }
         
+        if (!CreateTimelines()) {
+            std::cerr << "Failed to create queue timelines" << std::endl;
+            return false;
+        }
+        
+        // Without a cache pipelines still build, just without reuse across launches
+        if (!m_pipelineCache.Initialize(m_device, m_deviceProperties, info.pipelineCacheDirectory)) {
+            std::cerr << "Continuing without a pipeline cache" << std::endl;
+        }
+        
         std::cout << "VulkanDevice initialized successfully" << std::endl;
         return true;
     }
@@ -52,6 +63,12 @@ bool VulkanDevice::Initialize(const InitInfo& info) {
 }
 
 void VulkanDevice::Cleanup() {
+    // Written back before the device goes away
+    m_pipelineCache.Cleanup();
+    
+    m_transferTimeline.reset();
+    m_graphicsTimeline.reset();
+    
     if (m_device != VK_NULL_HANDLE) {
         vkDestroyDevice(m_device, nullptr);
         m_device = VK_NULL_HANDLE;
@@ -95,6 +112,13 @@ bool VulkanDevice::CreateInstance(const InitInfo& info) {
     createInfo.pApplicationInfo = &appInfo;
     
     auto extensions = GetRequiredExtensions(info);
+    
+    // Needed to query optional and timeline semaphore features on a 1.0 instance
+    m_hasPhysicalDeviceProperties2 = IsInstanceExtensionAvailable(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    if (m_hasPhysicalDeviceProperties2) {
+        extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    }
+    
     createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
     createInfo.ppEnabledExtensionNames = extensions.data();
     
@@ -206,10 +230,136 @@ bool VulkanDevice::PickPhysicalDevice() {
     vkGetPhysicalDeviceFeatures(m_physicalDevice, &m_deviceFeatures);
     
     std::cout << "Selected GPU: " << m_deviceProperties.deviceName << std::endl;
+    if (m_queueFamilyIndices.transferFamily != m_queueFamilyIndices.graphicsFamily) {
+        std::cout << "Using dedicated transfer queue family " << m_queueFamilyIndices.transferFamily.value() << std::endl;
+    }
+    
+    // Checked by IsDeviceSuitable; all queue synchronization is built on it
+    m_deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    
+    m_descriptorIndexing = QueryDescriptorIndexingSupport();
+    if (m_descriptorIndexing) {
+        m_deviceExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+        m_deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        std::cout << "Descriptor indexing available (" << m_maxUpdateAfterBindSampledImages
+                  << " update-after-bind sampled images)" << std::endl;
+    }
+
+    m_incrementalPresent = IsDeviceExtensionAvailable(m_physicalDevice, VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    if (m_incrementalPresent) {
+        m_deviceExtensions.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+        std::cout << "Incremental present available" << std::endl;
+    }
+    
+    m_presentWait = QueryPresentWaitSupport();
+    if (m_presentWait) {
+        m_deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        m_deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        std::cout << "Present wait available" << std::endl;
+    }
     
     return true;
 }
 
+bool VulkanDevice::QueryDescriptorIndexingSupport() {
+    if (!m_hasPhysicalDeviceProperties2 ||
+        !IsDeviceExtensionAvailable(m_physicalDevice, VK_KHR_MAINTENANCE3_EXTENSION_NAME) ||
+        !IsDeviceExtensionAvailable(m_physicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+        return false;
+    }
+    
+    auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2KHR) vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceFeatures2KHR");
+    auto getProperties2 = (PFN_vkGetPhysicalDeviceProperties2KHR) vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceProperties2KHR");
+    if (!getFeatures2 || !getProperties2) {
+        return false;
+    }
+    
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2KHR features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features2.pNext = &indexingFeatures;
+    getFeatures2(m_physicalDevice, &features2);
+    
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties{};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2KHR properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+    properties2.pNext = &indexingProperties;
+    getProperties2(m_physicalDevice, &properties2);
+    
+    m_maxUpdateAfterBindSampledImages = std::min(indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                                 indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+    
+    // The shader picks its texture by push constant, a dynamically uniform index into the array.
+    // Textures are written into free slots while earlier frames still use the set.
+    return features2.features.shaderSampledImageArrayDynamicIndexing &&
+           indexingFeatures.descriptorBindingPartiallyBound &&
+           indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+           indexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+}
+
+bool VulkanDevice::QueryPresentWaitSupport() {
+    if (!m_hasPhysicalDeviceProperties2 ||
+        !IsDeviceExtensionAvailable(m_physicalDevice, VK_KHR_PRESENT_ID_EXTENSION_NAME) ||
+        !IsDeviceExtensionAvailable(m_physicalDevice, VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        return false;
+    }
+    
+    auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2KHR) vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceFeatures2KHR");
+    if (!getFeatures2) {
+        return false;
+    }
+    
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    VkPhysicalDeviceFeatures2KHR features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features2.pNext = &presentIdFeatures;
+    getFeatures2(m_physicalDevice, &features2);
+    
+    return presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+}
+
+bool VulkanDevice::QueryTimelineSemaphoreSupport(VkPhysicalDevice device) const {
+    if (!m_hasPhysicalDeviceProperties2 ||
+        !IsDeviceExtensionAvailable(device, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) {
+        return false;
+    }
+    
+    auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2KHR) vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceFeatures2KHR");
+    if (!getFeatures2) {
+        return false;
+    }
+    
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    VkPhysicalDeviceFeatures2KHR features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features2.pNext = &timelineFeatures;
+    getFeatures2(device, &features2);
+    
+    return timelineFeatures.timelineSemaphore;
+}
+
+VkResult VulkanDevice::WaitForPresent(VkSwapchainKHR swapchain, uint64_t presentId, uint64_t timeout) const {
+    if (!m_vkWaitForPresent) {
+        return VK_ERROR_EXTENSION_NOT_PRESENT;
+    }
+    return m_vkWaitForPresent(m_device, swapchain, presentId, timeout);
+}
+
+VkResult VulkanDevice::WaitSemaphores(const VkSemaphoreWaitInfoKHR& waitInfo, uint64_t timeout) const {
+    return m_vkWaitSemaphores(m_device, &waitInfo, timeout);
+}
+
+VkResult VulkanDevice::GetSemaphoreCounterValue(VkSemaphore semaphore, uint64_t* value) const {
+    return m_vkGetSemaphoreCounterValue(m_device, semaphore, value);
+}
+
 bool VulkanDevice::CreateLogicalDevice() {
     QueueFamilyIndices indices = FindQueueFamilies(m_physicalDevice);
     
@@ -233,9 +383,40 @@ bool VulkanDevice::CreateLogicalDevice() {
     VkPhysicalDeviceFeatures deviceFeatures{};
     // Enable features we need
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = m_descriptorIndexing ? VK_TRUE : VK_FALSE;
+    
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+    indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    presentWaitFeatures.presentWait = VK_TRUE;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.presentId = VK_TRUE;
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timelineFeatures.timelineSemaphore = VK_TRUE;
+    
+    // Timeline semaphores are required; the optional extensions that were picked chain in front
+    void* featureChain = &timelineFeatures;
+    if (m_presentWait) {
+        presentWaitFeatures.pNext = featureChain;
+        featureChain = &presentIdFeatures;
+    }
+    if (m_descriptorIndexing) {
+        indexingFeatures.pNext = featureChain;
+        featureChain = &indexingFeatures;
+    }
     
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = featureChain;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
@@ -261,9 +442,66 @@ bool VulkanDevice::CreateLogicalDevice() {
     vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
     vkGetDeviceQueue(m_device, indices.transferFamily.value(), 0, &m_transferQueue);
     
+    m_vkWaitSemaphores = (PFN_vkWaitSemaphoresKHR) vkGetDeviceProcAddr(m_device, "vkWaitSemaphoresKHR");
+    m_vkGetSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValueKHR) vkGetDeviceProcAddr(m_device, "vkGetSemaphoreCounterValueKHR");
+    if (!m_vkWaitSemaphores || !m_vkGetSemaphoreCounterValue) {
+        std::cerr << "Failed to load timeline semaphore functions" << std::endl;
+        return false;
+    }
+    
+    if (m_presentWait) {
+        m_vkWaitForPresent = (PFN_vkWaitForPresentKHR) vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR");
+        m_presentWait = (m_vkWaitForPresent != nullptr);
+    }
+    
+    return true;
+}
+
+bool VulkanDevice::CreateTimelines() {
+    m_graphicsTimeline = std::make_unique<VulkanTimeline>();
+    if (!m_graphicsTimeline->Initialize(this, m_graphicsQueue)) {
+        return false;
+    }
+    
+    // A queue shared by both roles keeps one timeline, so its submissions stay under one lock
+    if (m_transferQueue != m_graphicsQueue) {
+        m_transferTimeline = std::make_unique<VulkanTimeline>();
+        if (!m_transferTimeline->Initialize(this, m_transferQueue)) {
+            return false;
+        }
+    }
+    
     return true;
 }
 
+VulkanTimeline* VulkanDevice::FindTimeline(VkQueue queue) const {
+    if (m_graphicsTimeline && m_graphicsTimeline->GetQueue() == queue) {
+        return m_graphicsTimeline.get();
+    }
+    if (m_transferTimeline && m_transferTimeline->GetQueue() == queue) {
+        return m_transferTimeline.get();
+    }
+    return nullptr;
+}
+
+VkResult VulkanDevice::QueuePresent(const VkPresentInfoKHR& presentInfo) {
+    // Usually the graphics queue, which workers submit uploads to at the same time
+    if (VulkanTimeline* timeline = FindTimeline(m_presentQueue)) {
+        return timeline->Present(presentInfo);
+    }
+    
+    // Only the swapchain uses a queue of its own
+    return vkQueuePresentKHR(m_presentQueue, &presentInfo);
+}
+
+VkResult VulkanDevice::WaitPresentQueueIdle() {
+    if (VulkanTimeline* timeline = FindTimeline(m_presentQueue)) {
+        return timeline->WaitQueueIdle();
+    }
+    
+    return vkQueueWaitIdle(m_presentQueue);
+}
+
 bool VulkanDevice::CheckValidationLayerSupport() const {
     uint32_t layerCount;
     vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
@@ -322,7 +560,8 @@ bool VulkanDevice::IsDeviceSuitable(VkPhysicalDevice device) const {
     VkPhysicalDeviceFeatures supportedFeatures;
     vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
     
-    return indices.IsComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
+    return indices.IsComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy &&
+           QueryTimelineSemaphoreSupport(device);
 }
 
 QueueFamilyIndices VulkanDevice::FindQueueFamilies(VkPhysicalDevice device) const {
@@ -334,30 +573,46 @@ QueueFamilyIndices VulkanDevice::FindQueueFamilies(VkPhysicalDevice device) cons
     std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
     
+    // Transfer prefers a family without graphics or compute (a DMA engine), then one
+    // without graphics; otherwise uploads share the graphics family
+    std::optional<uint32_t> dedicatedTransfer;
+    std::optional<uint32_t> separateTransfer;
+    
     int i = 0;
     for (const auto& queueFamily : queueFamilies) {
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+        if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphicsFamily.has_value()) {
             indices.graphicsFamily = i;
         }
         
         VkBool32 presentSupport = false;
         vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
         
-        if (presentSupport) {
+        if (presentSupport && !indices.presentFamily.has_value()) {
             indices.presentFamily = i;
         }
         
-        if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) {
-            indices.transferFamily = i;
-        }
-        
-        if (indices.IsComplete()) {
-            break;
+        if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            if (!(queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+                if (!dedicatedTransfer.has_value()) {
+                    dedicatedTransfer = i;
+                }
+            } else if (!separateTransfer.has_value()) {
+                separateTransfer = i;
+            }
         }
         
         i++;
     }
     
+    if (dedicatedTransfer.has_value()) {
+        indices.transferFamily = dedicatedTransfer;
+    } else if (separateTransfer.has_value()) {
+        indices.transferFamily = separateTransfer;
+    } else {
+        // Graphics queues always support transfer operations
+        indices.transferFamily = indices.graphicsFamily;
+    }
+    
     return indices;
 }
 
@@ -377,6 +632,36 @@ bool VulkanDevice::CheckDeviceExtensionSupport(VkPhysicalDevice device) const {
     return requiredExtensions.empty();
 }
 
+bool VulkanDevice::IsInstanceExtensionAvailable(const char* extensionName) const {
+    uint32_t extensionCount = 0;
+    vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+    
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+    
+    for (const auto& extension : availableExtensions) {
+        if (strcmp(extension.extensionName, extensionName) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool VulkanDevice::IsDeviceExtensionAvailable(VkPhysicalDevice device, const char* extensionName) const {
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+    
+    for (const auto& extension : availableExtensions) {
+        if (strcmp(extension.extensionName, extensionName) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 int VulkanDevice::RateDeviceSuitability(VkPhysicalDevice device) const {
     VkPhysicalDeviceProperties deviceProperties;
     VkPhysicalDeviceFeatures deviceFeatures;
@@ -501,13 +786,10 @@ VkCommandBuffer VulkanDevice::BeginSingleTimeCommands(VkCommandPool commandPool)
 void VulkanDevice::EndSingleTimeCommands(VkCommandBuffer commandBuffer, VkCommandPool commandPool) const {
     vkEndCommandBuffer(commandBuffer);
     
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_graphicsQueue);
+    // Waits for this submission only, not for everything else on the queue
+    VulkanTimeline::SubmitDesc submit;
+    submit.commandBuffers.push_back(commandBuffer);
+    m_graphicsTimeline->Wait(m_graphicsTimeline->Submit(submit));
     
     vkFreeCommandBuffers(m_device, commandPool, 1, &commandBuffer);
 }
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include "VulkanPipelineCache.h"
+#include "VulkanTimeline.h"
 #include <vector>
 #include <string>
 #include <optional>
+#include <memory>
 
 struct GLFWwindow;
 
@@ -32,6 +35,7 @@ public:
         bool enableValidation = false;
         std::vector<const char*> requiredExtensions;
         std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+        std::string pipelineCacheDirectory;     // Empty for the working directory
     };
     
     VulkanDevice();
@@ -47,11 +51,25 @@ public:
     VkDevice GetDevice() const { return m_device; }
     VkSurfaceKHR GetSurface() const { return m_surface; }
     
+    // Shared by all pipeline creation; persisted across launches
+    VkPipelineCache GetPipelineCache() const { return m_pipelineCache.GetHandle(); }
+    
     // Queue access
     VkQueue GetGraphicsQueue() const { return m_graphicsQueue; }
     VkQueue GetPresentQueue() const { return m_presentQueue; }
     VkQueue GetTransferQueue() const { return m_transferQueue; }
     
+    // GPU progress of each queue; every submission goes through these. The transfer timeline
+    // is the graphics one when the device has no dedicated transfer family.
+    VulkanTimeline* GetGraphicsTimeline() const { return m_graphicsTimeline.get(); }
+    VulkanTimeline* GetTransferTimeline() const {
+        return m_transferTimeline ? m_transferTimeline.get() : m_graphicsTimeline.get();
+    }
+    // Presents on the present queue, under the timeline's lock when it shares a timeline's queue
+    VkResult QueuePresent(const VkPresentInfoKHR& presentInfo);
+    // Waits until the present queue is idle, presents included; for rare teardown paths only
+    VkResult WaitPresentQueueIdle();
+    
     // Queue family indices
     const QueueFamilyIndices& GetQueueFamilyIndices() const { return m_queueFamilyIndices; }
     
@@ -59,6 +77,22 @@ public:
     const VkPhysicalDeviceProperties& GetDeviceProperties() const { return m_deviceProperties; }
     const VkPhysicalDeviceFeatures& GetDeviceFeatures() const { return m_deviceFeatures; }
     
+    // Optional VK_EXT_descriptor_indexing support, enabled when the device has it
+    bool SupportsDescriptorIndexing() const { return m_descriptorIndexing; }
+    uint32_t GetMaxUpdateAfterBindSampledImages() const { return m_maxUpdateAfterBindSampledImages; }
+
+    // Optional VK_KHR_incremental_present support, so presents can name the regions that changed
+    bool SupportsIncrementalPresent() const { return m_incrementalPresent; }
+    
+    // Optional VK_KHR_present_id + VK_KHR_present_wait support, so the CPU can wait for a
+    // given present to reach the screen
+    bool SupportsPresentWait() const { return m_presentWait; }
+    VkResult WaitForPresent(VkSwapchainKHR swapchain, uint64_t presentId, uint64_t timeout) const;
+    
+    // VK_KHR_timeline_semaphore, required; used through VulkanTimeline
+    VkResult WaitSemaphores(const VkSemaphoreWaitInfoKHR& waitInfo, uint64_t timeout) const;
+    VkResult GetSemaphoreCounterValue(VkSemaphore semaphore, uint64_t* value) const;
+    
     // Swapchain support
     SwapChainSupportDetails QuerySwapChainSupport() const;
     SwapChainSupportDetails QuerySwapChainSupportForDevice(VkPhysicalDevice device) const;
@@ -80,6 +114,8 @@ private:
     bool CreateSurface(GLFWwindow* window);
     bool PickPhysicalDevice();
     bool CreateLogicalDevice();
+    bool CreateTimelines();
+    VulkanTimeline* FindTimeline(VkQueue queue) const;
     
     // Helper functions
     bool CheckValidationLayerSupport() const;
@@ -87,6 +123,11 @@ private:
     bool IsDeviceSuitable(VkPhysicalDevice device) const;
     QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device) const;
     bool CheckDeviceExtensionSupport(VkPhysicalDevice device) const;
+    bool IsInstanceExtensionAvailable(const char* extensionName) const;
+    bool IsDeviceExtensionAvailable(VkPhysicalDevice device, const char* extensionName) const;
+    bool QueryDescriptorIndexingSupport();
+    bool QueryPresentWaitSupport();
+    bool QueryTimelineSemaphoreSupport(VkPhysicalDevice device) const;
     int RateDeviceSuitability(VkPhysicalDevice device) const;
     
     // Debug callback
@@ -102,16 +143,27 @@ private:
     VkSurfaceKHR m_surface = VK_NULL_HANDLE;
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
     VkDevice m_device = VK_NULL_HANDLE;
+    VulkanPipelineCache m_pipelineCache;
     
     // Queues
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
     VkQueue m_transferQueue = VK_NULL_HANDLE;
+    std::unique_ptr<VulkanTimeline> m_graphicsTimeline;
+    std::unique_ptr<VulkanTimeline> m_transferTimeline;     // Null when sharing the graphics queue
     
     // Device info
     QueueFamilyIndices m_queueFamilyIndices;
     VkPhysicalDeviceProperties m_deviceProperties;
     VkPhysicalDeviceFeatures m_deviceFeatures;
+    bool m_hasPhysicalDeviceProperties2 = false;
+    bool m_descriptorIndexing = false;
+    uint32_t m_maxUpdateAfterBindSampledImages = 0;
+    bool m_incrementalPresent = false;
+    bool m_presentWait = false;
+    PFN_vkWaitForPresentKHR m_vkWaitForPresent = nullptr;
+    PFN_vkWaitSemaphoresKHR m_vkWaitSemaphores = nullptr;
+    PFN_vkGetSemaphoreCounterValueKHR m_vkGetSemaphoreCounterValue = nullptr;
     
     // Configuration
     bool m_enableValidation = false;
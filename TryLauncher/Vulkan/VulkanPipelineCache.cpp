@@ -0,0 +1,210 @@
+#include "VulkanPipelineCache.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstring>
+
+VulkanPipelineCache::~VulkanPipelineCache() {
+    Cleanup();
+}
+
+bool VulkanPipelineCache::Initialize(VkDevice device, const VkPhysicalDeviceProperties& properties, const std::string& directory) {
+    m_device = device;
+    m_properties = properties;
+
+    // One file per GPU, so switching between two adapters does not throw either cache away
+    std::ostringstream fileName;
+    fileName << "pipeline_cache_" << std::hex << std::setfill('0')
+             << std::setw(4) << properties.vendorID << "_" << std::setw(4) << properties.deviceID << ".bin";
+    m_path = (std::filesystem::path(directory) / fileName.str()).string();
+
+    std::vector<uint8_t> data;
+    bool loaded = LoadFile(data);
+
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = loaded ? data.size() : 0;
+    createInfo.pInitialData = loaded ? data.data() : nullptr;
+
+    VkResult result = vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache);
+    if (result != VK_SUCCESS && loaded) {
+        // The driver refused the blob despite matching headers; start empty instead
+        std::cerr << "Pipeline cache: driver rejected " << m_path << ", starting empty" << std::endl;
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        loaded = false;
+        result = vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache);
+    }
+
+    if (result != VK_SUCCESS) {
+        std::cerr << "Failed to create pipeline cache: " << result << std::endl;
+        m_cache = VK_NULL_HANDLE;
+        return false;
+    }
+
+    if (loaded) {
+        std::cout << "Pipeline cache: loaded " << data.size() << " bytes from " << m_path << std::endl;
+    }
+    return true;
+}
+
+void VulkanPipelineCache::Cleanup() {
+    if (m_cache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    Save();
+    vkDestroyPipelineCache(m_device, m_cache, nullptr);
+    m_cache = VK_NULL_HANDLE;
+}
+
+bool VulkanPipelineCache::Save() const {
+    if (m_cache == VK_NULL_HANDLE) {
+        return false;
+    }
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> data(dataSize);
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, data.data()) != VK_SUCCESS) {
+        std::cerr << "Pipeline cache: failed to read cache data" << std::endl;
+        return false;
+    }
+    data.resize(dataSize);
+
+    FileHeader header;
+    FillHeader(header);
+    header.dataSize = dataSize;
+    header.dataHash = HashData(data.data(), data.size());
+
+    // Write next to the target and rename over it; readers only ever see a complete file
+    std::filesystem::path path(m_path);
+    std::filesystem::path tempPath(m_path + ".tmp");
+    std::error_code error;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Pipeline cache: failed to create " << tempPath.string() << std::endl;
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.flush();
+        if (!file.good()) {
+            std::cerr << "Pipeline cache: failed to write " << tempPath.string() << std::endl;
+            file.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Pipeline cache: failed to replace " << m_path << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    std::cout << "Pipeline cache: saved " << dataSize << " bytes to " << m_path << std::endl;
+    return true;
+}
+
+bool VulkanPipelineCache::LoadFile(std::vector<uint8_t>& data) const {
+    std::ifstream file(m_path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < static_cast<std::streamoff>(sizeof(FileHeader))) {
+        std::cerr << "Pipeline cache: " << m_path << " is truncated, ignoring it" << std::endl;
+        return false;
+    }
+
+    FileHeader header;
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    // Check the size before allocating; a damaged header must not drive a huge allocation
+    if (!file.good() || header.dataSize != static_cast<uint64_t>(fileSize) - sizeof(FileHeader)) {
+        std::cerr << "Pipeline cache: " << m_path << " is truncated, ignoring it" << std::endl;
+        return false;
+    }
+
+    data.resize(static_cast<size_t>(header.dataSize));
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file.good()) {
+        std::cerr << "Pipeline cache: failed to read " << m_path << std::endl;
+        return false;
+    }
+
+    if (!IsCompatible(header, data)) {
+        std::cout << "Pipeline cache: " << m_path << " does not match this GPU and driver or is damaged, ignoring it" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool VulkanPipelineCache::IsCompatible(const FileHeader& header, const std::vector<uint8_t>& data) const {
+    FileHeader expected;
+    FillHeader(expected);
+
+    if (header.magic != expected.magic ||
+        header.fileVersion != expected.fileVersion ||
+        header.vendorID != expected.vendorID ||
+        header.deviceID != expected.deviceID ||
+        header.driverVersion != expected.driverVersion ||
+        std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return false;
+    }
+
+    if (header.dataHash != HashData(data.data(), data.size())) {
+        return false;
+    }
+
+    // The driver's own header: size, version, vendor, device and cache UUID
+    const size_t driverHeaderSize = 16 + VK_UUID_SIZE;
+    if (data.size() < driverHeaderSize) {
+        return false;
+    }
+
+    uint32_t driverHeader[4];
+    std::memcpy(driverHeader, data.data(), sizeof(driverHeader));
+    return driverHeader[0] >= driverHeaderSize &&
+           driverHeader[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           driverHeader[2] == m_properties.vendorID &&
+           driverHeader[3] == m_properties.deviceID &&
+           std::memcmp(data.data() + 16, m_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+void VulkanPipelineCache::FillHeader(FileHeader& header) const {
+    // Cleared as a whole so padding bytes are deterministic on disk
+    std::memset(&header, 0, sizeof(header));
+    header.magic = FILE_MAGIC;
+    header.fileVersion = FILE_VERSION;
+    header.vendorID = m_properties.vendorID;
+    header.deviceID = m_properties.deviceID;
+    header.driverVersion = m_properties.driverVersion;
+    std::memcpy(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+uint64_t VulkanPipelineCache::HashData(const uint8_t* data, size_t size) {
+    // FNV-1a; catches truncation and bit rot, which can crash some drivers
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * VulkanPipelineCache keeps the driver's compiled pipelines across launches.
+ * This class handles:
+ * - Loading a cache blob from disk at startup, one file per vendor and device
+ * - Rejecting blobs written by another driver version or GPU, or truncated or corrupted ones
+ * - Writing the cache back on shutdown through a temporary file and a rename, so a crash
+ *   mid-write never leaves a damaged cache behind
+ *
+ * VulkanDevice owns the single instance; every vkCreate*Pipelines call in the engine should
+ * pass GetHandle() so all pipelines share one cache. A rejected or missing file only costs a
+ * cold start; the cache then starts out empty.
+ */
+class VulkanPipelineCache {
+public:
+    VulkanPipelineCache() = default;
+    ~VulkanPipelineCache();
+
+    VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+    VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+
+    // directory may be empty for the working directory
+    bool Initialize(VkDevice device, const VkPhysicalDeviceProperties& properties, const std::string& directory);
+
+    // Saves the cache, then destroys it
+    void Cleanup();
+
+    bool Save() const;
+
+    VkPipelineCache GetHandle() const { return m_cache; }
+    const std::string& GetPath() const { return m_path; }
+
+private:
+    // Written ahead of the driver's blob; the driver's own header is checked as well
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t fileVersion;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+
+    static constexpr uint32_t FILE_MAGIC = 0x43504C54;    // "TLPC"
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    bool LoadFile(std::vector<uint8_t>& data) const;
+    bool IsCompatible(const FileHeader& header, const std::vector<uint8_t>& data) const;
+    void FillHeader(FileHeader& header) const;
+    static uint64_t HashData(const uint8_t* data, size_t size);
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties m_properties = {};
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+    std::string m_path;
+};
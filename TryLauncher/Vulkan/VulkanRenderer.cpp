@@ -2,12 +2,36 @@
 #include "VulkanDevice.h"
 #include "VulkanSwapchain.h"
 #include "VulkanCommandBuffer.h"
+#include "ResourceManager.h"
 #include "../Core/SettingsManager.h"
 #include "../Core/EngineConfig.h"
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <stdexcept>
 
+std::atomic<bool> VulkanRenderer::s_windowOpen{false};
+
+namespace {
+    VulkanSwapchain::PresentSettings MakePresentSettings(const EngineConfig::Graphics& graphics) {
+        VulkanSwapchain::PresentSettings settings;
+        settings.enableVSync = graphics.vsync;
+        settings.framesInFlight = graphics.framesInFlight;
+        settings.lowLatency = graphics.lowLatency;
+        
+        // "auto" leaves the choice to enableVSync
+        if (graphics.presentMode == "fifo") {
+            settings.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        } else if (graphics.presentMode == "fifo_relaxed") {
+            settings.presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        } else if (graphics.presentMode == "mailbox") {
+            settings.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+        } else if (graphics.presentMode == "immediate") {
+            settings.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+        }
+        return settings;
+    }
+}
+
 VulkanRenderer::VulkanRenderer(SettingsManager* settingsManager)
     : m_settingsManager(settingsManager) {
 }
@@ -52,6 +76,7 @@ bool VulkanRenderer::Initialize() {
             glfwTerminate();
             return false;
         }
+        s_windowOpen.store(true, std::memory_order_release);
         
         // Initialize Vulkan device
         m_device = std::make_unique<VulkanDevice>();
@@ -107,12 +132,24 @@ void VulkanRenderer::Update(float deltaTime) {
         return;
     }
     
+    // Low-latency mode: hold off until the last frame is on screen, so the input polled next
+    // is as fresh as possible when its frame is displayed
+    if (m_swapchain) {
+        m_swapchain->WaitForFrameLatency();
+    }
+    
     // Poll events
     glfwPollEvents();
     
     // TODO: Implement rendering loop in later tasks
 }
 
+void VulkanRenderer::DeclareUpdateAccess(ModuleAccess& access) const {
+    access.Writes(GetName());
+    // glfwPollEvents dispatches the window callbacks that mutate InputManager
+    access.Writes("InputManager");
+}
+
 void VulkanRenderer::Shutdown() {
     if (!m_initialized) {
         return;
@@ -145,6 +182,7 @@ void VulkanRenderer::Shutdown() {
     
     // Cleanup GLFW
     if (m_window) {
+        s_windowOpen.store(false, std::memory_order_release);
         glfwDestroyWindow(m_window);
         m_window = nullptr;
     }
@@ -169,10 +207,47 @@ void VulkanRenderer::BeginFrame() {
     }
     
     // Acquire next image from swapchain
-    if (!m_swapchain->AcquireNextImage(m_currentImageIndex)) {
+    m_imageAcquired = m_swapchain->AcquireNextImage(m_currentImageIndex);
+    if (!m_imageAcquired) {
         // Swapchain is out of date, will be recreated on next frame
         return;
     }
+    
+    // The slot's previous frame has finished, so its command pools can be reset
+    m_commandBuffer->BeginFrame(m_swapchain->GetCurrentFrame());
+    
+    // The previous frame has been submitted, so resources retired during it get their timeline value
+    if (m_resourceManager) {
+        m_resourceManager->BeginFrame();
+    }
+}
+
+uint64_t VulkanRenderer::SubmitFrame(VkCommandBuffer commandBuffer,
+                                     const std::vector<VulkanTimeline::WaitPoint>& waits) {
+    // Without an acquired image the semaphores below would never signal
+    if (!m_initialized || !m_swapchain || !m_imageAcquired) {
+        return 0;
+    }
+    
+    VulkanTimeline::SubmitDesc submit;
+    submit.commandBuffers.push_back(commandBuffer);
+    submit.waits = waits;
+    
+    VulkanTimeline::WaitPoint imageAvailable;
+    imageAvailable.semaphore = m_swapchain->GetImageAvailableSemaphore();
+    imageAvailable.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    submit.waits.push_back(imageAvailable);
+    submit.signalSemaphores.push_back(m_swapchain->GetRenderFinishedSemaphore());
+    
+    uint64_t value = m_device->GetGraphicsTimeline()->Submit(submit);
+    if (value == 0) {
+        std::cerr << "Failed to submit frame" << std::endl;
+        return 0;
+    }
+    
+    m_swapchain->SetFrameTimelineValue(value);
+    m_frameSubmitted = true;
+    return value;
 }
 
 void VulkanRenderer::EndFrame() {
@@ -180,6 +255,13 @@ void VulkanRenderer::EndFrame() {
         return;
     }
     
+    // Nothing would signal the present's semaphore, and the frame slot was never used
+    if (!m_imageAcquired || !m_frameSubmitted) {
+        m_imageAcquired = false;
+        m_frameSubmitted = false;
+        return;
+    }
+    
     // Present the image
     if (!m_swapchain->PresentImage(m_currentImageIndex)) {
         // Swapchain is out of date, will be recreated on next frame
@@ -188,6 +270,8 @@ void VulkanRenderer::EndFrame() {
     
     // Advance to next frame
     m_swapchain->AdvanceFrame();
+    m_imageAcquired = false;
+    m_frameSubmitted = false;
 }
 
 void VulkanRenderer::WaitIdle() {
@@ -196,6 +280,20 @@ void VulkanRenderer::WaitIdle() {
     }
 }
 
+void VulkanRenderer::WaitEvents(double timeout) {
+    if (!m_initialized || glfwWindowShouldClose(m_window)) {
+        return;
+    }
+    
+    glfwWaitEventsTimeout(timeout);
+}
+
+void VulkanRenderer::Wake() {
+    if (s_windowOpen.load(std::memory_order_acquire)) {
+        glfwPostEmptyEvent();
+    }
+}
+
 VkCommandBuffer VulkanRenderer::BeginSingleTimeCommands() {
     if (!m_commandBuffer) {
         throw std::runtime_error("VulkanCommandBuffer not initialized");
@@ -235,10 +333,22 @@ VkQueue VulkanRenderer::GetTransferQueue() const {
     return m_device ? m_device->GetTransferQueue() : VK_NULL_HANDLE;
 }
 
+VulkanTimeline* VulkanRenderer::GetGraphicsTimeline() const {
+    return m_device ? m_device->GetGraphicsTimeline() : nullptr;
+}
+
+VulkanTimeline* VulkanRenderer::GetTransferTimeline() const {
+    return m_device ? m_device->GetTransferTimeline() : nullptr;
+}
+
 VkCommandPool VulkanRenderer::GetCommandPool() const {
     return m_commandBuffer ? m_commandBuffer->GetCommandPool() : VK_NULL_HANDLE;
 }
 
+VkPipelineCache VulkanRenderer::GetPipelineCache() const {
+    return m_device ? m_device->GetPipelineCache() : VK_NULL_HANDLE;
+}
+
 bool VulkanRenderer::CreateCommandBuffers() {
     // Create the VulkanCommandBuffer management system
     m_commandBuffer = std::make_unique<VulkanCommandBuffer>();
@@ -250,6 +360,8 @@ bool VulkanRenderer::CreateCommandBuffers() {
     commandBufferInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
     commandBufferInfo.poolFlags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     commandBufferInfo.initialCommandBufferCount = 1; // Start with one command buffer
+    // One pool slot per frame slot; sized for the bound so the setting can change at runtime
+    commandBufferInfo.frameCount = VulkanSwapchain::MAX_FRAMES_IN_FLIGHT;
     
     if (!m_commandBuffer->Initialize(commandBufferInfo)) {
         std::cerr << "Failed to initialize VulkanCommandBuffer" << std::endl;
@@ -268,7 +380,9 @@ bool VulkanRenderer::CreateSwapchain() {
     swapchainInfo.window = m_window;
     swapchainInfo.preferredWidth = 0; // Use window size
     swapchainInfo.preferredHeight = 0; // Use window size
-    swapchainInfo.enableVSync = true; // Will be configurable later via SettingsManager
+    if (m_settingsManager) {
+        swapchainInfo.present = MakePresentSettings(m_settingsManager->GetConfig().graphics);
+    }
     
     if (!m_swapchain->Initialize(swapchainInfo)) {
         std::cerr << "Failed to initialize swapchain" << std::endl;
@@ -286,8 +400,8 @@ void VulkanRenderer::ApplyGraphicsSettings(const EngineConfig::Graphics& graphic
     
     std::cout << "Applying graphics settings..." << std::endl;
     
-    // Wait for device to be idle before making changes
-    WaitIdle();
+    // No device wait: size, mode and present changes all go through swapchain recreation,
+    // which hands the old swapchain off while its frames finish
     
     // Apply window size changes
     if (m_window) {
@@ -318,11 +432,10 @@ void VulkanRenderer::ApplyGraphicsSettings(const EngineConfig::Graphics& graphic
         }
     }
     
-    // Apply VSync setting
+    // Present mode, VSync, frames in flight and latency mode
     if (m_swapchain) {
-        // VSync changes require swapchain recreation
-        // This will be handled during the next frame when swapchain is recreated
-        m_framebufferResized = true;
+        // These require swapchain recreation, which happens at the start of the next frame
+        m_swapchain->SetPresentSettings(MakePresentSettings(graphics));
     }
     
     // Note: MSAA and validation settings require more complex changes
@@ -6,10 +6,12 @@
 #include "VulkanSwapchain.h"
 #include "VulkanCommandBuffer.h"
 #include <vulkan/vulkan.h>
+#include <atomic>
 #include <memory>
 
 struct GLFWwindow;
 class SettingsManager;
+class ResourceManager;
 
 class VulkanRenderer : public IEngineModule {
 public:
@@ -28,12 +30,33 @@ public:
     void Shutdown() override;
     const char* GetName() const override { return "VulkanRenderer"; }
     int GetInitializationOrder() const override { return 300; }
+    ModuleThreadAffinity GetThreadAffinity() const override { return ModuleThreadAffinity::MainThread; }
+    void DeclareUpdateAccess(ModuleAccess& access) const override;
 
-    // Vulkan-specific methods
+    // Vulkan-specific methods. BeginFrame also marks the frame for the ResourceManager's
+    // deferred destruction, whichever modules record into it.
     void BeginFrame();
     void EndFrame();
     void WaitIdle();
     
+    // Submits the frame's commands between BeginFrame and EndFrame. Waits for the acquired image
+    // and any extra points (uploads, other queues), signals the present and the graphics
+    // timeline; the frame slot is reused once the returned value is reached. 0 on failure.
+    uint64_t SubmitFrame(VkCommandBuffer commandBuffer,
+                         const std::vector<VulkanTimeline::WaitPoint>& waits = {});
+    
+    // GPU progress, one timeline per queue: the current value, waits for a value and
+    // submissions that signal the next one. Null before initialization.
+    VulkanTimeline* GetGraphicsTimeline() const;
+    VulkanTimeline* GetTransferTimeline() const;
+    
+    // Blocks until a window event arrives or timeout seconds pass, dispatching the
+    // event callbacks like Update's poll does. Main thread only.
+    void WaitEvents(double timeout);
+    // Makes a WaitEvents in progress return, e.g. for work finished on another thread.
+    // Safe from any thread; does nothing while there is no window.
+    static void Wake();
+    
     // Resource creation
     VkCommandBuffer BeginSingleTimeCommands();
     void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
@@ -45,10 +68,14 @@ public:
     VkQueue GetPresentQueue() const;
     VkQueue GetTransferQueue() const;
     VkCommandPool GetCommandPool() const;
+    VkPipelineCache GetPipelineCache() const;
     VulkanDevice* GetVulkanDevice() const { return m_device.get(); }
     VulkanSwapchain* GetSwapchain() const { return m_swapchain.get(); }
     VulkanCommandBuffer* GetCommandBuffer() const { return m_commandBuffer.get(); }
     
+    // Created after the renderer, which it depends on; null detaches it before shutdown
+    void SetResourceManager(ResourceManager* resourceManager) { m_resourceManager = resourceManager; }
+    
     // Window resize handling
     void OnWindowResize();
     
@@ -64,10 +91,14 @@ private:
     std::unique_ptr<VulkanDevice> m_device;
     std::unique_ptr<VulkanSwapchain> m_swapchain;
     std::unique_ptr<VulkanCommandBuffer> m_commandBuffer;
+    ResourceManager* m_resourceManager = nullptr;
     GLFWwindow* m_window = nullptr;
+    static std::atomic<bool> s_windowOpen;  // Wake may run on workers during startup and shutdown
     
     // Frame state
     uint32_t m_currentImageIndex = 0;
+    bool m_imageAcquired = false;
+    bool m_frameSubmitted = false;  // SubmitFrame signaled the image's renderFinished semaphore
     bool m_framebufferResized = false;
     
     bool m_initialized = false;
@@ -23,16 +23,11 @@ bool VulkanSwapchain::Initialize(const InitInfo& info) {
     m_window = info.window;
     
     try {
-        if (!CreateSwapchain()) {
+        if (!CreateSwapchain(VK_NULL_HANDLE)) {
             std::cerr << "Failed to create swapchain" << std::endl;
             return false;
         }
         
-        if (!CreateImageViews()) {
-            std::cerr << "Failed to create image views" << std::endl;
-            return false;
-        }
-        
         if (!CreateSyncObjects()) {
             std::cerr << "Failed to create synchronization objects" << std::endl;
             return false;
@@ -42,6 +37,8 @@ bool VulkanSwapchain::Initialize(const InitInfo& info) {
         std::cout << "  Format: " << m_swapchainImageFormat << std::endl;
         std::cout << "  Extent: " << m_swapchainExtent.width << "x" << m_swapchainExtent.height << std::endl;
         std::cout << "  Images: " << m_swapchainImages.size() << std::endl;
+        std::cout << "  Present mode: " << m_presentMode << ", frames in flight: " << m_framesInFlight
+                  << (IsLowLatencyActive() ? ", low latency" : "") << std::endl;
         
         return true;
     }
@@ -57,9 +54,10 @@ void VulkanSwapchain::Cleanup() {
         return;
     }
     
-    // Wait for device to be idle before cleanup
+    // Shutdown only; recreation hands the swapchain off without waiting for the device
     vkDeviceWaitIdle(m_device->GetDevice());
     
+    DestroyRetiredSwapchains(true);
     CleanupSyncObjects();
     CleanupSwapchain();
 }
@@ -69,8 +67,11 @@ bool VulkanSwapchain::AcquireNextImage(uint32_t& imageIndex) {
         return false;
     }
     
-    // Wait for the current frame's fence
-    vkWaitForFences(m_device->GetDevice(), 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
+    // Wait for the frame that last used this slot
+    m_device->GetGraphicsTimeline()->Wait(m_frameTimelineValues[m_currentFrame]);
+    
+    // That completes the oldest frame in flight, which may free a retired swapchain
+    DestroyRetiredSwapchains(false);
     
     VkResult result = vkAcquireNextImageKHR(
         m_device->GetDevice(),
@@ -89,9 +90,6 @@ bool VulkanSwapchain::AcquireNextImage(uint32_t& imageIndex) {
         return false;
     }
     
-    // Reset the fence only if we're submitting work
-    vkResetFences(m_device->GetDevice(), 1, &m_inFlightFences[m_currentFrame]);
-    
     return true;
 }
 
@@ -112,8 +110,35 @@ bool VulkanSwapchain::PresentImage(uint32_t imageIndex) {
     presentInfo.pSwapchains = swapchains;
     presentInfo.pImageIndices = &imageIndex;
     presentInfo.pResults = nullptr; // Optional
+
+    // Only chained when the device enabled VK_KHR_incremental_present
+    VkPresentRegionKHR region{};
+    VkPresentRegionsKHR presentRegions{};
+    if (m_device->SupportsIncrementalPresent() && !m_presentRegions.empty()) {
+        region.rectangleCount = static_cast<uint32_t>(m_presentRegions.size());
+        region.pRectangles = m_presentRegions.data();
+
+        presentRegions.sType = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR;
+        presentRegions.swapchainCount = 1;
+        presentRegions.pRegions = &region;
+        presentRegions.pNext = presentInfo.pNext;
+        presentInfo.pNext = &presentRegions;
+    }
+
+    // Tagged so WaitForFrameLatency can wait for this present to reach the screen
+    uint64_t presentId = m_lastPresentId + 1;
+    VkPresentIdKHR presentIdInfo{};
+    if (IsLowLatencyActive()) {
+        presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentIdInfo.swapchainCount = 1;
+        presentIdInfo.pPresentIds = &presentId;
+        presentIdInfo.pNext = presentInfo.pNext;
+        presentInfo.pNext = &presentIdInfo;
+        m_lastPresentId = presentId;
+    }
     
-    VkResult result = vkQueuePresentKHR(m_device->GetPresentQueue(), &presentInfo);
+    VkResult result = m_device->QueuePresent(presentInfo);
+    m_presentRegions.clear();
     
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
         m_outOfDate = true;
@@ -126,6 +151,55 @@ bool VulkanSwapchain::PresentImage(uint32_t imageIndex) {
     return true;
 }
 
+void VulkanSwapchain::SetPresentRegions(const std::vector<VkRect2D>& regions) {
+    m_presentRegions.clear();
+    for (const VkRect2D& rect : regions) {
+        // Rectangles must lie within the swapchain extent
+        int32_t left = std::max(rect.offset.x, 0);
+        int32_t top = std::max(rect.offset.y, 0);
+        int32_t right = std::min(rect.offset.x + static_cast<int32_t>(rect.extent.width),
+                                 static_cast<int32_t>(m_swapchainExtent.width));
+        int32_t bottom = std::min(rect.offset.y + static_cast<int32_t>(rect.extent.height),
+                                  static_cast<int32_t>(m_swapchainExtent.height));
+        if (right <= left || bottom <= top) {
+            continue;
+        }
+
+        VkRectLayerKHR layerRect{};
+        layerRect.offset = {left, top};
+        layerRect.extent = {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)};
+        layerRect.layer = 0;
+        m_presentRegions.push_back(layerRect);
+    }
+}
+
+void VulkanSwapchain::WaitForFrameLatency() {
+    if (!IsLowLatencyActive() || m_swapchain == VK_NULL_HANDLE || m_lastPresentId < m_framesInFlight) {
+        return;
+    }
+    
+    // With one frame in flight this waits for the previous present itself
+    uint64_t targetId = m_lastPresentId - (m_framesInFlight - 1);
+    VkResult result = m_device->WaitForPresent(m_swapchain, targetId, PRESENT_WAIT_TIMEOUT_NS);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        m_outOfDate = true;
+    } else if (result != VK_SUCCESS && result != VK_TIMEOUT) {
+        std::cerr << "Failed to wait for present! Error code: " << result << std::endl;
+    }
+}
+
+void VulkanSwapchain::SetPresentSettings(const PresentSettings& settings) {
+    m_initInfo.present = settings;
+    m_initInfo.present.framesInFlight = std::clamp(settings.framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    
+    // Present mode and frame slots are fixed per swapchain
+    m_outOfDate = true;
+}
+
+bool VulkanSwapchain::IsLowLatencyActive() const {
+    return m_initInfo.present.lowLatency && m_device && m_device->SupportsPresentWait();
+}
+
 bool VulkanSwapchain::RecreateSwapchain() {
     if (!m_device || !m_window) {
         return false;
@@ -139,23 +213,50 @@ bool VulkanSwapchain::RecreateSwapchain() {
         glfwWaitEvents();
     }
     
-    // Wait for device to be idle
-    vkDeviceWaitIdle(m_device->GetDevice());
+    // Hand the old swapchain to the new one instead of waiting for the device: the presentation
+    // engine can reuse its resources, and frames in flight keep rendering to and presenting its
+    // images. Creation retires the old swapchain even if it fails.
+    VkSwapchainKHR oldSwapchain = m_swapchain;
+    RetiredSwapchain retired;
+    retired.swapchain = oldSwapchain;
+    retired.imageViews = std::move(m_swapchainImageViews);
+    // Frames up to m_frameCount - 1 may use it; the last of them completes when its frame slot
+    // comes around again
+    retired.retireFrame = m_frameCount + m_framesInFlight - 1;
+    retired.lastPresentId = m_lastPresentId;
+    m_swapchain = VK_NULL_HANDLE;
+    m_swapchainImages.clear();
+    m_swapchainImageViews.clear();
     
-    // Cleanup old swapchain
-    CleanupSwapchain();
+    bool created = CreateSwapchain(oldSwapchain);
+    if (oldSwapchain != VK_NULL_HANDLE) {
+        m_retiredSwapchains.push_back(std::move(retired));
+    }
     
-    // Create new swapchain
-    if (!CreateSwapchain()) {
-        std::cerr << "Failed to recreate swapchain" << std::endl;
-        return false;
+    // Frame slots can only be rebuilt once none is in use. Waiting for the latest slot value
+    // still leaves the other queues running, and covers rendering to every retired swapchain.
+    // Timeline values say nothing about presents, which may still wait on renderFinished
+    // semaphores or show a retired swapchain's images, so the present queue has to drain too.
+    if (m_framesInFlight != m_initInfo.present.framesInFlight) {
+        m_device->GetGraphicsTimeline()->Wait(
+            *std::max_element(m_frameTimelineValues.begin(), m_frameTimelineValues.end()));
+        m_device->WaitPresentQueueIdle();
+        DestroyRetiredSwapchains(true);
+        CleanupSyncObjects();
+        if (!CreateSyncObjects()) {
+            std::cerr << "Failed to recreate synchronization objects" << std::endl;
+            return false;
+        }
+        m_currentFrame = 0;
     }
     
-    if (!CreateImageViews()) {
-        std::cerr << "Failed to recreate image views" << std::endl;
+    // Stays out of date so the next frame tries again
+    if (!created) {
+        std::cerr << "Failed to recreate swapchain" << std::endl;
         return false;
     }
     
+    ++m_generation;
     m_outOfDate = false;
     
     std::cout << "Swapchain recreated successfully" << std::endl;
@@ -164,7 +265,7 @@ bool VulkanSwapchain::RecreateSwapchain() {
     return true;
 }
 
-bool VulkanSwapchain::CreateSwapchain() {
+bool VulkanSwapchain::CreateSwapchain(VkSwapchainKHR oldSwapchain) {
     SwapChainSupportDetails swapChainSupport = m_device->QuerySwapChainSupport();
     
     VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.formats);
@@ -208,18 +309,24 @@ bool VulkanSwapchain::CreateSwapchain() {
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
-    createInfo.oldSwapchain = VK_NULL_HANDLE; // For swapchain recreation
+    createInfo.oldSwapchain = oldSwapchain;
     
     VkResult result = vkCreateSwapchainKHR(m_device->GetDevice(), &createInfo, nullptr, &m_swapchain);
     if (result != VK_SUCCESS) {
         std::cerr << "Failed to create swapchain! Error code: " << result << std::endl;
+        m_swapchain = VK_NULL_HANDLE;
         return false;
     }
     
+    // Present IDs start over with each swapchain
+    m_presentMode = presentMode;
+    m_lastPresentId = 0;
+    
     // Get swapchain images
     vkGetSwapchainImagesKHR(m_device->GetDevice(), m_swapchain, &imageCount, nullptr);
     m_swapchainImages.resize(imageCount);
     vkGetSwapchainImagesKHR(m_device->GetDevice(), m_swapchain, &imageCount, m_swapchainImages.data());
+    m_swapchainImageViews.assign(imageCount, VK_NULL_HANDLE);
     
     // Store format and extent
     m_swapchainImageFormat = surfaceFormat.format;
@@ -228,13 +335,16 @@ bool VulkanSwapchain::CreateSwapchain() {
     return true;
 }
 
-bool VulkanSwapchain::CreateImageViews() {
-    m_swapchainImageViews.resize(m_swapchainImages.size());
+VkImageView VulkanSwapchain::GetImageView(uint32_t imageIndex) {
+    if (imageIndex >= m_swapchainImages.size()) {
+        return VK_NULL_HANDLE;
+    }
     
-    for (size_t i = 0; i < m_swapchainImages.size(); i++) {
+    // Views are made on first use, so a recreation costs nothing until an image is drawn to
+    if (m_swapchainImageViews[imageIndex] == VK_NULL_HANDLE) {
         VkImageViewCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        createInfo.image = m_swapchainImages[i];
+        createInfo.image = m_swapchainImages[imageIndex];
         createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
         createInfo.format = m_swapchainImageFormat;
         
@@ -249,34 +359,32 @@ bool VulkanSwapchain::CreateImageViews() {
         createInfo.subresourceRange.baseArrayLayer = 0;
         createInfo.subresourceRange.layerCount = 1;
         
-        VkResult result = vkCreateImageView(m_device->GetDevice(), &createInfo, nullptr, &m_swapchainImageViews[i]);
+        VkResult result = vkCreateImageView(m_device->GetDevice(), &createInfo, nullptr, &m_swapchainImageViews[imageIndex]);
         if (result != VK_SUCCESS) {
-            std::cerr << "Failed to create image view " << i << "! Error code: " << result << std::endl;
-            return false;
+            std::cerr << "Failed to create image view " << imageIndex << "! Error code: " << result << std::endl;
+            m_swapchainImageViews[imageIndex] = VK_NULL_HANDLE;
         }
     }
     
-    return true;
+    return m_swapchainImageViews[imageIndex];
 }
 
 bool VulkanSwapchain::CreateSyncObjects() {
-    m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    m_framesInFlight = std::clamp(m_initInfo.present.framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    m_imageAvailableSemaphores.resize(m_framesInFlight);
+    m_renderFinishedSemaphores.resize(m_framesInFlight);
+    // Value 0 is always reached, so fresh slots never wait
+    m_frameTimelineValues.assign(m_framesInFlight, 0);
     
+    // Binary, since presentation cannot wait on a timeline semaphore
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
     
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Start in signaled state
-    
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < m_framesInFlight; i++) {
         VkResult result1 = vkCreateSemaphore(m_device->GetDevice(), &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]);
         VkResult result2 = vkCreateSemaphore(m_device->GetDevice(), &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]);
-        VkResult result3 = vkCreateFence(m_device->GetDevice(), &fenceInfo, nullptr, &m_inFlightFences[i]);
         
-        if (result1 != VK_SUCCESS || result2 != VK_SUCCESS || result3 != VK_SUCCESS) {
+        if (result1 != VK_SUCCESS || result2 != VK_SUCCESS) {
             std::cerr << "Failed to create synchronization objects for frame " << i << std::endl;
             return false;
         }
@@ -299,8 +407,18 @@ VkSurfaceFormatKHR VulkanSwapchain::ChooseSwapSurfaceFormat(const std::vector<Vk
 }
 
 VkPresentModeKHR VulkanSwapchain::ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) {
+    // An explicitly requested mode wins when the surface supports it
+    VkPresentModeKHR requested = m_initInfo.present.presentMode;
+    if (requested != VK_PRESENT_MODE_MAX_ENUM_KHR) {
+        if (std::find(availablePresentModes.begin(), availablePresentModes.end(), requested) != availablePresentModes.end()) {
+            return requested;
+        }
+        std::cout << "Present mode " << requested << " not supported by the surface, using FIFO" << std::endl;
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+    
     // If VSync is disabled, prefer mailbox mode for lower latency
-    if (!m_initInfo.enableVSync) {
+    if (!m_initInfo.present.enableVSync) {
         for (const auto& availablePresentMode : availablePresentModes) {
             if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
                 return availablePresentMode;
@@ -354,9 +472,11 @@ void VulkanSwapchain::CleanupSwapchain() {
         return;
     }
     
-    // Cleanup image views
+    // Cleanup image views; images never drawn to have none
     for (auto imageView : m_swapchainImageViews) {
-        vkDestroyImageView(m_device->GetDevice(), imageView, nullptr);
+        if (imageView != VK_NULL_HANDLE) {
+            vkDestroyImageView(m_device->GetDevice(), imageView, nullptr);
+        }
     }
     m_swapchainImageViews.clear();
     
@@ -370,6 +490,45 @@ void VulkanSwapchain::CleanupSwapchain() {
     m_swapchainImages.clear();
 }
 
+void VulkanSwapchain::DestroyRetiredSwapchains(bool all) {
+    if (!m_device || m_device->GetDevice() == VK_NULL_HANDLE) {
+        return;
+    }
+    
+    // Callers destroying all of them have already drained the present queue
+    bool presentsDone = all;
+    
+    auto it = m_retiredSwapchains.begin();
+    while (it != m_retiredSwapchains.end()) {
+        if (!all && it->retireFrame > m_frameCount) {
+            ++it;
+            continue;
+        }
+        
+        // The timeline only covers rendering. Its last present may still be waiting on a
+        // renderFinished semaphore or holding an image, so wait for that present by ID, or
+        // drain the present queue when it was not tagged or the wait did not succeed.
+        if (!presentsDone) {
+            VkResult result = VK_INCOMPLETE;
+            if (it->lastPresentId != 0 && m_device->SupportsPresentWait()) {
+                result = m_device->WaitForPresent(it->swapchain, it->lastPresentId, PRESENT_WAIT_TIMEOUT_NS);
+            }
+            if (result != VK_SUCCESS) {
+                m_device->WaitPresentQueueIdle();
+                presentsDone = true;
+            }
+        }
+        
+        for (VkImageView imageView : it->imageViews) {
+            if (imageView != VK_NULL_HANDLE) {
+                vkDestroyImageView(m_device->GetDevice(), imageView, nullptr);
+            }
+        }
+        vkDestroySwapchainKHR(m_device->GetDevice(), it->swapchain, nullptr);
+        it = m_retiredSwapchains.erase(it);
+    }
+}
+
 void VulkanSwapchain::CleanupSyncObjects() {
     if (!m_device || m_device->GetDevice() == VK_NULL_HANDLE) {
         return;
@@ -382,12 +541,9 @@ void VulkanSwapchain::CleanupSyncObjects() {
         if (i < m_renderFinishedSemaphores.size()) {
             vkDestroySemaphore(m_device->GetDevice(), m_renderFinishedSemaphores[i], nullptr);
         }
-        if (i < m_inFlightFences.size()) {
-            vkDestroyFence(m_device->GetDevice(), m_inFlightFences[i], nullptr);
-        }
     }
     
     m_imageAvailableSemaphores.clear();
     m_renderFinishedSemaphores.clear();
-    m_inFlightFences.clear();
+    m_frameTimelineValues.clear();
 }
\ No newline at end of file
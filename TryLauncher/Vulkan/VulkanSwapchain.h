@@ -9,12 +9,25 @@ struct GLFWwindow;
 
 class VulkanSwapchain {
 public:
+    // Upper bound for framesInFlight; frame-keyed bookkeeping elsewhere is sized for it
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+    
+    // How frames are queued for display; changed at runtime through SetPresentSettings
+    struct PresentSettings {
+        bool enableVSync = true;
+        // VK_PRESENT_MODE_MAX_ENUM_KHR picks from enableVSync; an unsupported mode falls back to FIFO
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+        uint32_t framesInFlight = 2;    // 1..MAX_FRAMES_IN_FLIGHT
+        // WaitForFrameLatency blocks until the previous present is on screen (needs present wait)
+        bool lowLatency = false;
+    };
+    
     struct InitInfo {
         VulkanDevice* device = nullptr;
         GLFWwindow* window = nullptr;
         uint32_t preferredWidth = 0;
         uint32_t preferredHeight = 0;
-        bool enableVSync = true;
+        PresentSettings present;
     };
     
     VulkanSwapchain();
@@ -27,6 +40,20 @@ public:
     // Frame operations
     bool AcquireNextImage(uint32_t& imageIndex);
     bool PresentImage(uint32_t imageIndex);
+
+    // Regions of the next presented image that differ from the previous one; a hint the
+    // compositor may use to copy less. Empty means the whole image. Cleared by PresentImage.
+    void SetPresentRegions(const std::vector<VkRect2D>& regions);
+    
+    // In low-latency mode, blocks until the CPU is at most framesInFlight - 1 presents ahead of
+    // the display. Call before sampling input so the frame reflects the freshest input.
+    void WaitForFrameLatency();
+    
+    // Takes effect at the next RecreateSwapchain, which this requests
+    void SetPresentSettings(const PresentSettings& settings);
+    const PresentSettings& GetPresentSettings() const { return m_initInfo.present; }
+    VkPresentModeKHR GetPresentMode() const { return m_presentMode; }
+    bool IsLowLatencyActive() const;
     
     // Swapchain recreation (for window resize)
     bool RecreateSwapchain();
@@ -38,24 +65,42 @@ public:
     VkFormat GetImageFormat() const { return m_swapchainImageFormat; }
     VkExtent2D GetExtent() const { return m_swapchainExtent; }
     const std::vector<VkImage>& GetImages() const { return m_swapchainImages; }
-    const std::vector<VkImageView>& GetImageViews() const { return m_swapchainImageViews; }
+    // Created on first request; VK_NULL_HANDLE for an invalid index or on failure
+    VkImageView GetImageView(uint32_t imageIndex);
     uint32_t GetImageCount() const { return static_cast<uint32_t>(m_swapchainImages.size()); }
+    // Bumped by every recreation; framebuffers built against an older generation must be rebuilt
+    uint64_t GetGeneration() const { return m_generation; }
     
     // Synchronization objects
     VkSemaphore GetImageAvailableSemaphore() const { return m_imageAvailableSemaphores[m_currentFrame]; }
     VkSemaphore GetRenderFinishedSemaphore() const { return m_renderFinishedSemaphores[m_currentFrame]; }
-    VkFence GetInFlightFence() const { return m_inFlightFences[m_currentFrame]; }
+    // Graphics timeline value the current frame slot's submission signaled; AcquireNextImage
+    // waits for it before the slot is reused
+    void SetFrameTimelineValue(uint64_t value) { m_frameTimelineValues[m_currentFrame] = value; }
     
     // Frame management
-    void AdvanceFrame() { m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT; }
+    void AdvanceFrame() {
+        m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+        ++m_frameCount;
+    }
     uint32_t GetCurrentFrame() const { return m_currentFrame; }
+    uint32_t GetFramesInFlight() const { return m_framesInFlight; }
     
-    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+    // Bounds how long WaitForFrameLatency blocks, e.g. while the window is hidden
+    static constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 100'000'000;
 
 private:
+    // A swapchain replaced by recreation, destroyed once the frames that used it completed
+    // and their presents finished
+    struct RetiredSwapchain {
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+        std::vector<VkImageView> imageViews;
+        uint64_t retireFrame = 0;   // Destroyable once m_frameCount reaches this after a slot wait
+        uint64_t lastPresentId = 0; // ID of its last present, 0 if presents were not tagged
+    };
+    
     // Swapchain creation helpers
-    bool CreateSwapchain();
-    bool CreateImageViews();
+    bool CreateSwapchain(VkSwapchainKHR oldSwapchain);
     bool CreateSyncObjects();
     
     // Swapchain configuration helpers
@@ -66,6 +111,7 @@ private:
     // Cleanup helpers
     void CleanupSwapchain();
     void CleanupSyncObjects();
+    void DestroyRetiredSwapchains(bool all);
     
     // Configuration
     InitInfo m_initInfo;
@@ -73,18 +119,27 @@ private:
     // Vulkan objects
     VkSwapchainKHR m_swapchain = VK_NULL_HANDLE;
     std::vector<VkImage> m_swapchainImages;
-    std::vector<VkImageView> m_swapchainImageViews;
+    std::vector<VkImageView> m_swapchainImageViews;     // VK_NULL_HANDLE until first requested
+    std::vector<RetiredSwapchain> m_retiredSwapchains;
+    uint64_t m_generation = 0;
     VkFormat m_swapchainImageFormat;
     VkExtent2D m_swapchainExtent;
     
     // Synchronization objects
     std::vector<VkSemaphore> m_imageAvailableSemaphores;
     std::vector<VkSemaphore> m_renderFinishedSemaphores;
-    std::vector<VkFence> m_inFlightFences;
+    std::vector<uint64_t> m_frameTimelineValues;    // 0 until the slot's first submission
     
     // Frame management
     uint32_t m_currentFrame = 0;
+    uint64_t m_frameCount = 0;      // Frames advanced past since initialization
+    uint32_t m_framesInFlight = 1;  // Frame slots with sync objects
+    VkPresentModeKHR m_presentMode = VK_PRESENT_MODE_FIFO_KHR;
     bool m_outOfDate = false;
+    std::vector<VkRectLayerKHR> m_presentRegions;
+    
+    // Present IDs are per swapchain and must increase; 0 means no present yet
+    uint64_t m_lastPresentId = 0;
     
     // References (not owned)
     VulkanDevice* m_device = nullptr;
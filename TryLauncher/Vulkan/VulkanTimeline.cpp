@@ -0,0 +1,157 @@
+#include "VulkanTimeline.h"
+#include "VulkanDevice.h"
+#include <iostream>
+
+VulkanTimeline::VulkanTimeline() = default;
+
+VulkanTimeline::~VulkanTimeline() {
+    Cleanup();
+}
+
+bool VulkanTimeline::Initialize(VulkanDevice* device, VkQueue queue) {
+    if (!device || queue == VK_NULL_HANDLE) {
+        std::cerr << "VulkanTimeline: Invalid device or queue" << std::endl;
+        return false;
+    }
+
+    m_device = device;
+    m_queue = queue;
+
+    VkSemaphoreTypeCreateInfoKHR typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    VkResult result = vkCreateSemaphore(m_device->GetDevice(), &semaphoreInfo, nullptr, &m_semaphore);
+    if (result != VK_SUCCESS) {
+        std::cerr << "VulkanTimeline: Failed to create timeline semaphore: " << result << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanTimeline::Cleanup() {
+    if (m_semaphore != VK_NULL_HANDLE) {
+        vkDestroySemaphore(m_device->GetDevice(), m_semaphore, nullptr);
+        m_semaphore = VK_NULL_HANDLE;
+    }
+}
+
+uint64_t VulkanTimeline::Submit(const SubmitDesc& desc) {
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<uint64_t> waitValues;
+    std::vector<VkPipelineStageFlags> waitStages;
+    waitSemaphores.reserve(desc.waits.size());
+    waitValues.reserve(desc.waits.size());
+    waitStages.reserve(desc.waits.size());
+    for (const WaitPoint& wait : desc.waits) {
+        waitSemaphores.push_back(wait.semaphore);
+        waitValues.push_back(wait.value);
+        waitStages.push_back(wait.stages);
+    }
+
+    // The timeline goes last; values for the binary semaphores before it are ignored
+    std::vector<VkSemaphore> signalSemaphores = desc.signalSemaphores;
+    signalSemaphores.push_back(m_semaphore);
+    std::vector<uint64_t> signalValues(signalSemaphores.size(), 0);
+
+    // Values must be signaled in increasing order, so they are taken under the queue's lock
+    std::lock_guard<std::mutex> lock(m_submitMutex);
+    uint64_t value = m_submittedValue.load(std::memory_order_relaxed) + 1;
+    signalValues.back() = value;
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.empty() ? nullptr : waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.empty() ? nullptr : waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.empty() ? nullptr : waitStages.data();
+    submitInfo.commandBufferCount = static_cast<uint32_t>(desc.commandBuffers.size());
+    submitInfo.pCommandBuffers = desc.commandBuffers.empty() ? nullptr : desc.commandBuffers.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    VkResult result = vkQueueSubmit(m_queue, 1, &submitInfo, desc.fence);
+    if (result != VK_SUCCESS) {
+        std::cerr << "VulkanTimeline: Failed to submit: " << result << std::endl;
+        return 0;
+    }
+
+    m_submittedValue.store(value, std::memory_order_release);
+    return value;
+}
+
+VkResult VulkanTimeline::Present(const VkPresentInfoKHR& presentInfo) {
+    std::lock_guard<std::mutex> lock(m_submitMutex);
+    return vkQueuePresentKHR(m_queue, &presentInfo);
+}
+
+VkResult VulkanTimeline::WaitQueueIdle() {
+    std::lock_guard<std::mutex> lock(m_submitMutex);
+    return vkQueueWaitIdle(m_queue);
+}
+
+uint64_t VulkanTimeline::GetCompletedValue() const {
+    uint64_t value = 0;
+    if (m_device->GetSemaphoreCounterValue(m_semaphore, &value) != VK_SUCCESS) {
+        return m_completedValue.load(std::memory_order_acquire);
+    }
+
+    RecordCompleted(value);
+    return value;
+}
+
+bool VulkanTimeline::IsComplete(uint64_t value) const {
+    return value <= m_completedValue.load(std::memory_order_acquire) || value <= GetCompletedValue();
+}
+
+bool VulkanTimeline::Wait(uint64_t value, uint64_t timeout) const {
+    if (value <= m_completedValue.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    VkSemaphoreWaitInfoKHR waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_semaphore;
+    waitInfo.pValues = &value;
+
+    VkResult result = m_device->WaitSemaphores(waitInfo, timeout);
+    if (result == VK_TIMEOUT) {
+        return false;
+    }
+    if (result != VK_SUCCESS) {
+        std::cerr << "VulkanTimeline: Failed to wait for value " << value << ": " << result << std::endl;
+        return false;
+    }
+
+    RecordCompleted(value);
+    return true;
+}
+
+void VulkanTimeline::RecordCompleted(uint64_t value) const {
+    // Other threads may have stored a newer value meanwhile; never move the cache backwards
+    uint64_t cached = m_completedValue.load(std::memory_order_relaxed);
+    while (cached < value && !m_completedValue.compare_exchange_weak(cached, value, std::memory_order_release)) {
+    }
+}
+
+VulkanTimeline::WaitPoint VulkanTimeline::At(uint64_t value, VkPipelineStageFlags stages) const {
+    WaitPoint point;
+    point.semaphore = m_semaphore;
+    point.value = value;
+    point.stages = stages;
+    return point;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class VulkanDevice;
+
+/**
+ * VulkanTimeline tracks the progress of one queue with a timeline semaphore.
+ * This class handles:
+ * - Submitting to the queue, each submission signaling the next value of the semaphore
+ * - Telling whether the GPU reached a value without blocking, or waiting for it
+ * - Letting a submission wait on the GPU for a value of any queue's timeline
+ *
+ * All submissions to the queue go through Submit, and presents on it through Present.
+ * Both take the same lock (queues are externally synchronized), and Submit keeps values in
+ * submission order. A value is therefore reached once the submission that signaled it, and
+ * every submission to the queue before it, has finished.
+ * Nothing is reset between uses, so any thread may ask about any value at any time.
+ */
+class VulkanTimeline {
+public:
+    // A semaphore state a submission waits for before the given stages run
+    struct WaitPoint {
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        uint64_t value = 0;     // Ignored for binary semaphores
+        VkPipelineStageFlags stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    };
+
+    struct SubmitDesc {
+        std::vector<VkCommandBuffer> commandBuffers;    // May be empty to only signal
+        std::vector<WaitPoint> waits;
+        std::vector<VkSemaphore> signalSemaphores;      // Binary, for presentation
+        VkFence fence = VK_NULL_HANDLE;
+    };
+
+    VulkanTimeline();
+    ~VulkanTimeline();
+
+    VulkanTimeline(const VulkanTimeline&) = delete;
+    VulkanTimeline& operator=(const VulkanTimeline&) = delete;
+
+    // Initialization and cleanup
+    bool Initialize(VulkanDevice* device, VkQueue queue);
+    void Cleanup();
+
+    // Returns the value the submission signals, or 0 if it failed. Safe from any thread.
+    uint64_t Submit(const SubmitDesc& desc);
+    // vkQueuePresentKHR under the queue's lock, for a present queue shared with this one
+    VkResult Present(const VkPresentInfoKHR& presentInfo);
+    // vkQueueWaitIdle under the queue's lock; unlike Wait it also covers presents
+    VkResult WaitQueueIdle();
+
+    // Value signaled by the latest submission
+    uint64_t GetSubmittedValue() const { return m_submittedValue.load(std::memory_order_acquire); }
+    // Value the GPU has reached
+    uint64_t GetCompletedValue() const;
+    bool IsComplete(uint64_t value) const;
+
+    // True once value is reached, false on timeout (nanoseconds) or error
+    bool Wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+    // Waits for everything submitted so far, leaving other queues running
+    bool WaitIdle() const { return Wait(GetSubmittedValue()); }
+
+    // For another submission, possibly on another queue, to wait on value
+    WaitPoint At(uint64_t value, VkPipelineStageFlags stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT) const;
+
+    // Getters
+    VkSemaphore GetSemaphore() const { return m_semaphore; }
+    VkQueue GetQueue() const { return m_queue; }
+
+private:
+    void RecordCompleted(uint64_t value) const;
+
+    VulkanDevice* m_device = nullptr;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    VkSemaphore m_semaphore = VK_NULL_HANDLE;
+
+    std::mutex m_submitMutex;
+    std::atomic<uint64_t> m_submittedValue{0};
+    // Highest value seen reached, so most queries skip the driver
+    mutable std::atomic<uint64_t> m_completedValue{0};
+};